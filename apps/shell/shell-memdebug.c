@@ -40,6 +40,7 @@
 
 #include "contiki.h"
 #include "shell-memdebug.h"
+#include "lib/memb.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -55,6 +56,13 @@ SHELL_COMMAND(peek_command,
 	      "peek",
 	      "peek <address>: read a byte from address <address>",
 	      &shell_peek_process);
+#if MEMB_STATS
+PROCESS(shell_memb_process, "memb");
+SHELL_COMMAND(memb_command,
+	      "memb",
+	      "memb: show the usage of memory blocks",
+	      &shell_memb_process);
+#endif /* MEMB_STATS */
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(shell_poke_process, ev, data)
 {
@@ -119,10 +127,32 @@ PROCESS_THREAD(shell_peek_process, ev, data)
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+PROCESS_THREAD(shell_memb_process, ev, data)
+{
+  struct memb *m;
+  char buf[80];
+
+  PROCESS_BEGIN();
+
+  for(m = memb_list_head(); m != NULL; m = m->list_next) {
+    snprintf(buf, sizeof(buf),
+             ": %u of %u used, max %u, %u failed, %u bytes each",
+             m->used, m->num, m->max_used, m->failed, m->size);
+    shell_output_str(&memb_command, (char *)m->name, buf);
+  }
+
+  PROCESS_END();
+}
+#endif /* MEMB_STATS */
+/*---------------------------------------------------------------------------*/
 void
 shell_memdebug_init(void)
 {
   shell_register_command(&poke_command);
   shell_register_command(&peek_command);
+#if MEMB_STATS
+  shell_register_command(&memb_command);
+#endif /* MEMB_STATS */
 }
 /*---------------------------------------------------------------------------*/
@@ -32,7 +32,17 @@
 
 /**
  * \file
- *         A brief description of what this file is.
+ *         The 'profile' command, which shows how much time each
+ *         process spends running. Needs PROCESS_CONF_PROFILE.
+ *
+ *         "profile" prints the profiles as text, "profile -r" clears
+ *         them, and "profile -b" writes them as binary records that
+ *         can be piped to a file for offline analysis. All numbers in
+ *         the binary format are little-endian:
+ *
+ *         header:  'P' 'F' version(1) bins(1) ticks-per-second(4)
+ *         process: calls(4) time(4) max-time(4) histogram(4 * bins)
+ *                  name-length(1) name
  * \author
  *         Adam Dunkels <adam@sics.se>
  */
@@ -41,47 +51,102 @@
 #include "contiki-conf.h"
 #include "shell-profile.h"
 
-#include "loader/symbols.h"
-
 #include <stdio.h>
 #include <string.h>
 
+#define DUMP_VERSION 1
+
 /*---------------------------------------------------------------------------*/
 PROCESS(shell_profile_process, "Shell 'profile' command");
 SHELL_COMMAND(profile_command,
 	      "profile",
-	      "profile: show aggregate profiling information",
+	      "profile [-r|-b]: show, reset or dump process run times",
 	      &shell_profile_process);
 /*---------------------------------------------------------------------------*/
-PROCESS_THREAD(shell_profile_process, ev, data)
+#if PROCESS_PROFILE
+static uint8_t *
+put32(uint8_t *ptr, unsigned long value)
+{
+  ptr[0] = value;
+  ptr[1] = value >> 8;
+  ptr[2] = value >> 16;
+  ptr[3] = value >> 24;
+  return ptr + 4;
+}
+/*---------------------------------------------------------------------------*/
+static void
+dump(void)
 {
+  uint8_t buf[4 * (3 + PROCESS_PROFILE_BINS) + 1];
+  uint8_t *ptr;
+  struct process *p;
+  const char *name;
   int i;
-  char buf[100];
-  PROCESS_BEGIN();
 
-#if DETAILED_AGGREGATES
-  for(i = 0; i < aggregates_list_ptr; ++i) {
-    sprintf(buf, "-- %s: %lu / %u = %lu", aggregates[i].ptr,
-	   aggregates[i].cycles,
-	   aggregates[i].episodes,
-	   aggregates[i].cycles / aggregates[i].episodes);
-    shell_output(buf, "");
+  buf[0] = 'P';
+  buf[1] = 'F';
+  buf[2] = DUMP_VERSION;
+  buf[3] = PROCESS_PROFILE_BINS;
+  ptr = put32(&buf[4], RTIMER_SECOND);
+  shell_output(&profile_command, buf, ptr - buf, "", 0);
+
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    ptr = put32(buf, p->profile.calls);
+    ptr = put32(ptr, p->profile.time);
+    ptr = put32(ptr, p->profile.max_time);
+    for(i = 0; i < PROCESS_PROFILE_BINS; i++) {
+      ptr = put32(ptr, p->profile.histogram[i]);
+    }
+    name = PROCESS_NAME_STRING(p);
+    *ptr++ = strlen(name) > 255 ? 255 : strlen(name);
+    shell_output(&profile_command, buf, ptr - buf, name, ptr[-1]);
   }
-#else
-  for(i = 0; i < aggregates_list_ptr; ++i) {
-    sprintf(buf, "-- %c%c: %lu / %u = %lu",
-	   aggregates[i].ptr[0], aggregates[i].ptr[1],
-	   aggregates[i].cycles,
-	   aggregates[i].episodes,
-	   aggregates[i].cycles / aggregates[i].episodes);
-    shell_output(buf, "");
+}
+/*---------------------------------------------------------------------------*/
+static void
+show(void)
+{
+  char buf[80];
+  struct process *p;
+  int i, len;
+
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    snprintf(buf, sizeof(buf), ": %lu calls, %lu ticks, max %lu",
+             p->profile.calls, p->profile.time,
+             (unsigned long)p->profile.max_time);
+    shell_output_str(&profile_command, (char *)PROCESS_NAME_STRING(p), buf);
+
+    len = snprintf(buf, sizeof(buf), "  histogram");
+    for(i = 0; i < PROCESS_PROFILE_BINS && len < sizeof(buf); i++) {
+      len += snprintf(buf + len, sizeof(buf) - len, " %lu",
+                      p->profile.histogram[i]);
+    }
+    shell_output_str(&profile_command, buf, "");
+  }
+}
+#endif /* PROCESS_PROFILE */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_profile_process, ev, data)
+{
+#if PROCESS_PROFILE
+  const char *args = data;
+#endif /* PROCESS_PROFILE */
+
+  PROCESS_BEGIN();
+
+#if PROCESS_PROFILE
+  if(args != NULL && strncmp(args, "-r", 2) == 0) {
+    process_profile_reset();
+  } else if(args != NULL && strncmp(args, "-b", 2) == 0) {
+    dump();
+  } else {
+    show();
   }
-#endif
+#else /* PROCESS_PROFILE */
+  shell_output_str(&profile_command,
+                   "profile: needs PROCESS_CONF_PROFILE", "");
+#endif /* PROCESS_PROFILE */
 
-  sprintf(buf, "Memory for aggregates: %d * %d = %d\n",
-	  (int)sizeof(struct aggregate), aggregates_list_ptr,
-	  (int)sizeof(struct aggregate) * aggregates_list_ptr);
-  shell_output(buf, "");
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
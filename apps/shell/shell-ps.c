@@ -59,8 +59,29 @@ PROCESS_THREAD(shell_ps_process, ev, data)
   for(p = PROCESS_LIST(); p != NULL; p = p->next) {
     char namebuf[30];
     strncpy(namebuf, PROCESS_NAME_STRING(p), sizeof(namebuf));
+#if PROCESS_STATS_PER_PROCESS
+    {
+      char statbuf[60];
+      snprintf(statbuf, sizeof(statbuf),
+               ": queued %u max %u events %lu latency avg %lu max %lu",
+               p->stats.nevents, p->stats.maxevents, p->stats.dispatched,
+               p->stats.dispatched > 0 ?
+               p->stats.total_latency / p->stats.dispatched : 0,
+               (unsigned long)p->stats.max_latency);
+      shell_output_str(&ps_command, namebuf, statbuf);
+    }
+#else /* PROCESS_STATS_PER_PROCESS */
     shell_output_str(&ps_command, namebuf, "");
+#endif /* PROCESS_STATS_PER_PROCESS */
   }
+#if PROCESS_CONF_STATS
+  {
+    char statbuf[40];
+    snprintf(statbuf, sizeof(statbuf), "%u of %u",
+             process_maxevents, PROCESS_CONF_NUMEVENTS);
+    shell_output_str(&ps_command, "Largest event queue: ", statbuf);
+  }
+#endif /* PROCESS_CONF_STATS */
 
   PROCESS_END();
 }
@@ -387,6 +387,7 @@ struct shell_input {
 #include "shell-ping.h"
 #include "shell-power.h"
 #include "shell-powertrace.h"
+#include "shell-profile.h"
 #include "shell-ps.h"
 #include "shell-reboot.h"
 #include "shell-rime-debug.h"
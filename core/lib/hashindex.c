@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Hash index over the entries of a fixed-size array.
+ */
+
+#include "lib/hashindex.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+slot_get(const struct hashindex *h, uint16_t slot)
+{
+  if(h->wide) {
+    return h->slots[2 * slot] | (h->slots[2 * slot + 1] << 8);
+  }
+  return h->slots[slot];
+}
+/*---------------------------------------------------------------------------*/
+static void
+slot_set(struct hashindex *h, uint16_t slot, uint16_t value)
+{
+  if(h->wide) {
+    h->slots[2 * slot] = value & 0xff;
+    h->slots[2 * slot + 1] = value >> 8;
+  } else {
+    h->slots[slot] = value;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+hashindex_init(struct hashindex *h)
+{
+  memset(h->slots, 0, h->wide ? 2 * h->size : h->size);
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+hashindex_home(const struct hashindex *h, const void *key)
+{
+  /* 32-bit FNV-1a */
+  const uint8_t *p = key;
+  uint32_t hash = 2166136261UL;
+  int i;
+
+  for(i = 0; i < h->key_len; i++) {
+    hash = (hash ^ p[i]) * 16777619UL;
+  }
+  return hash % h->size;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+hashindex_next(const struct hashindex *h, uint16_t slot)
+{
+  return slot + 1 == h->size ? 0 : slot + 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+hashindex_get(const struct hashindex *h, uint16_t slot)
+{
+  return (int)slot_get(h, slot) - 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+hashindex_lookup(const struct hashindex *h, const void *key)
+{
+  uint16_t slot;
+  int index;
+
+  for(slot = hashindex_home(h, key);
+      (index = hashindex_get(h, slot)) >= 0;
+      slot = hashindex_next(h, slot)) {
+    if(memcmp(h->key(index), key, h->key_len) == 0) {
+      return index;
+    }
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+void
+hashindex_add(struct hashindex *h, uint16_t index)
+{
+  uint16_t slot = hashindex_home(h, h->key(index));
+
+  while(slot_get(h, slot) != 0) {
+    slot = hashindex_next(h, slot);
+  }
+  slot_set(h, slot, index + 1);
+}
+/*---------------------------------------------------------------------------*/
+void
+hashindex_remove(struct hashindex *h, uint16_t index)
+{
+  uint16_t i, j, home, value;
+
+  i = hashindex_home(h, h->key(index));
+  while((value = slot_get(h, i)) != index + 1) {
+    if(value == 0) {
+      return;
+    }
+    i = hashindex_next(h, i);
+  }
+  j = i;
+  while(1) {
+    j = hashindex_next(h, j);
+    value = slot_get(h, j);
+    if(value == 0) {
+      break;
+    }
+    home = hashindex_home(h, h->key(value - 1));
+    /* The entry can move to i unless its home lies cyclically
+       within (i, j] */
+    if(i <= j ? (home <= i || home > j) : (home <= i && home > j)) {
+      slot_set(h, i, value);
+      i = j;
+    }
+  }
+  slot_set(h, i, 0);
+}
+/*---------------------------------------------------------------------------*/
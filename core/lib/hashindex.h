@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Hash index over the entries of a fixed-size array, looked up
+ *         by a key stored in each entry.
+ */
+
+#ifndef HASHINDEX_H_
+#define HASHINDEX_H_
+
+#include "contiki-conf.h"
+
+/*
+ * The index is open-addressed with linear probing, and has two slots
+ * per array entry so that it is at most half full and probe sequences
+ * stay short. Each slot holds an entry index plus one, or zero if it is
+ * empty; slots take one byte when the array has fewer than 255 entries
+ * and two bytes otherwise. Removal moves later entries of a probe
+ * sequence back, so no lookup ever has to step over a hole.
+ *
+ * The index does not store keys: the key function returns a pointer to
+ * the key_len key bytes of an array entry, which the index hashes and
+ * compares. The entry must hold its key while it is in the index.
+ */
+
+struct hashindex {
+  uint8_t *slots;
+  uint16_t size;
+  uint8_t wide;
+  uint8_t key_len;
+  const void *(* key)(uint16_t index);
+};
+
+/**
+ * \brief Declare a hash index
+ * \param name The name of the hash index
+ * \param num The number of entries of the array that is indexed
+ * \param key_len The length of the keys, in bytes
+ * \param key Function returning the key of an array entry
+ */
+#define HASHINDEX(name, num, key_len, key) \
+        static uint8_t CC_CONCAT(name,_hashindex_slots)[2 * (num) * ((num) < 255 ? 1 : 2)]; \
+        static struct hashindex name = {CC_CONCAT(name,_hashindex_slots), \
+                                        2 * (num), (num) >= 255, (key_len), (key)}
+
+/**
+ * \brief Empty a hash index
+ * \param h Pointer to the hash index
+ */
+void hashindex_init(struct hashindex *h);
+
+/**
+ * \brief Get the slot where the probe sequence for a key starts
+ * \param h Pointer to the hash index
+ * \param key Pointer to the key bytes
+ * \return The home slot of the key
+ */
+uint16_t hashindex_home(const struct hashindex *h, const void *key);
+
+/**
+ * \brief Get the slot that follows a slot in a probe sequence
+ * \param h Pointer to the hash index
+ * \param slot A slot
+ * \return The next slot
+ */
+uint16_t hashindex_next(const struct hashindex *h, uint16_t slot);
+
+/**
+ * \brief Get the array entry in a slot
+ * \param h Pointer to the hash index
+ * \param slot A slot
+ * \retval >= 0 The index of the entry in the slot
+ * \retval -1 The slot is empty, which ends a probe sequence
+ *
+ * Together with hashindex_home() and hashindex_next(), this lets
+ * callers walk all entries whose key hashes like a given key, for
+ * lookups that match on more than the key bytes.
+ */
+int hashindex_get(const struct hashindex *h, uint16_t slot);
+
+/**
+ * \brief Look up an array entry by key
+ * \param h Pointer to the hash index
+ * \param key Pointer to the key bytes
+ * \retval >= 0 The index of the first entry found with the key
+ * \retval -1 No entry has the key
+ */
+int hashindex_lookup(const struct hashindex *h, const void *key);
+
+/**
+ * \brief Add an array entry to a hash index
+ * \param h Pointer to the hash index
+ * \param index The index of the entry, which must hold its key
+ */
+void hashindex_add(struct hashindex *h, uint16_t index);
+
+/**
+ * \brief Remove an array entry from a hash index
+ * \param h Pointer to the hash index
+ * \param index The index of the entry, which must still hold the key
+ *        it was added with
+ *
+ * Removing an entry that is not in the index has no effect.
+ */
+void hashindex_remove(struct hashindex *h, uint16_t index);
+
+#endif /* HASHINDEX_H_ */
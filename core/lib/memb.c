@@ -47,12 +47,31 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+#if MEMB_STATS
+static struct memb *memb_list;
+#endif /* MEMB_STATS */
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
   memset(m->count, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+#if MEMB_FREE_LIST
+  m->free = 0;
+  m->unused = 0;
+#endif /* MEMB_FREE_LIST */
+#if MEMB_FREE_LIST || MEMB_STATS
+  m->used = 0;
+#endif /* MEMB_FREE_LIST || MEMB_STATS */
+#if MEMB_STATS
+  m->max_used = 0;
+  m->failed = 0;
+  if(!m->listed) {
+    m->listed = 1;
+    m->list_next = memb_list;
+    memb_list = m;
+  }
+#endif /* MEMB_STATS */
 }
 /*---------------------------------------------------------------------------*/
 void *
@@ -60,18 +79,46 @@ memb_alloc(struct memb *m)
 {
   int i;
 
+#if MEMB_FREE_LIST
+  /* Chunks that have been freed are reused first. Until the first
+     chunk is freed, they are handed out in order. */
+  if(m->free != 0) {
+    i = m->free - 1;
+    m->free = m->next[i];
+  } else if(m->unused < m->num) {
+    i = m->unused++;
+  } else {
+    i = m->num;
+  }
+#else /* MEMB_FREE_LIST */
   for(i = 0; i < m->num; ++i) {
     if(m->count[i] == 0) {
-      /* If this block was unused, we increase the reference count to
-	 indicate that it now is used and return a pointer to the
-	 memory block. */
-      ++(m->count[i]);
-      return (void *)((char *)m->mem + (i * m->size));
+      break;
     }
   }
+#endif /* MEMB_FREE_LIST */
+
+  if(i < m->num) {
+    /* If this block was unused, we increase the reference count to
+       indicate that it now is used and return a pointer to the
+       memory block. */
+    ++(m->count[i]);
+#if MEMB_FREE_LIST || MEMB_STATS
+    ++m->used;
+#endif /* MEMB_FREE_LIST || MEMB_STATS */
+#if MEMB_STATS
+    if(m->used > m->max_used) {
+      m->max_used = m->used;
+    }
+#endif /* MEMB_STATS */
+    return (void *)((char *)m->mem + (i * m->size));
+  }
 
   /* No free block was found, so we return NULL to indicate failure to
      allocate block. */
+#if MEMB_STATS
+  ++m->failed;
+#endif /* MEMB_STATS */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -79,25 +126,33 @@ char
 memb_free(struct memb *m, void *ptr)
 {
   int i;
-  char *ptr2;
+  unsigned long offset;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    
-    if(ptr2 == (char *)ptr) {
-      /* We've found to block to which "ptr" points so we decrease the
-	 reference count and return the new value of it. */
-      if(m->count[i] > 0) {
-	/* Make sure that we don't deallocate free memory. */
-	--(m->count[i]);
-      }
-      return m->count[i];
+  /* Find the block to which the pointer "ptr" points from its offset
+     in the memory block. */
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+  offset = (unsigned long)((char *)ptr - (char *)m->mem);
+  if(offset % m->size != 0) {
+    return -1;
+  }
+  i = offset / m->size;
+
+  if(m->count[i] > 0) {
+    /* Make sure that we don't deallocate free memory. */
+    --(m->count[i]);
+    if(m->count[i] == 0) {
+#if MEMB_FREE_LIST
+      m->next[i] = m->free;
+      m->free = i + 1;
+#endif /* MEMB_FREE_LIST */
+#if MEMB_FREE_LIST || MEMB_STATS
+      --m->used;
+#endif /* MEMB_FREE_LIST || MEMB_STATS */
     }
-    ptr2 += m->size;
   }
-  return -1;
+  return m->count[i];
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -110,6 +165,9 @@ memb_inmemb(struct memb *m, void *ptr)
 int
 memb_numfree(struct memb *m)
 {
+#if MEMB_FREE_LIST
+  return m->num - m->used;
+#else /* MEMB_FREE_LIST */
   int i;
   int num_free = 0;
 
@@ -120,5 +178,14 @@ memb_numfree(struct memb *m)
   }
 
   return num_free;
+#endif /* MEMB_FREE_LIST */
+}
+/*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+struct memb *
+memb_list_head(void)
+{
+  return memb_list;
 }
+#endif /* MEMB_STATS */
 /** @} */
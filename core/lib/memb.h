@@ -65,6 +65,45 @@
 
 #include "sys/cc.h"
 
+/*
+ * With MEMB_CONF_FREE_LIST, each memory block keeps a list of its free
+ * chunks, so that memb_alloc() and memb_numfree() run in constant
+ * time instead of scanning the chunks. This costs two bytes of RAM
+ * per chunk.
+ */
+#ifdef MEMB_CONF_FREE_LIST
+#define MEMB_FREE_LIST MEMB_CONF_FREE_LIST
+#else /* MEMB_CONF_FREE_LIST */
+#define MEMB_FREE_LIST 0
+#endif /* MEMB_CONF_FREE_LIST */
+
+/*
+ * With MEMB_CONF_STATS, each memory block counts the largest number
+ * of chunks allocated at once and the number of failed allocations.
+ * Memory blocks are put on a list by memb_init() so that the
+ * statistics of all of them can be listed with memb_list_head().
+ */
+#ifdef MEMB_CONF_STATS
+#define MEMB_STATS MEMB_CONF_STATS
+#else /* MEMB_CONF_STATS */
+#define MEMB_STATS 0
+#endif /* MEMB_CONF_STATS */
+
+#if MEMB_FREE_LIST
+#define MEMB_FREE_LIST_DECLARE(name, num) \
+        static unsigned short CC_CONCAT(name,_memb_next)[num];
+#define MEMB_FREE_LIST_INIT(name) , CC_CONCAT(name,_memb_next)
+#else /* MEMB_FREE_LIST */
+#define MEMB_FREE_LIST_DECLARE(name, num)
+#define MEMB_FREE_LIST_INIT(name)
+#endif /* MEMB_FREE_LIST */
+
+#if MEMB_STATS
+#define MEMB_STATS_INIT(name) , #name
+#else /* MEMB_STATS */
+#define MEMB_STATS_INIT(name)
+#endif /* MEMB_STATS */
+
 /**
  * Declare a memory block.
  *
@@ -89,15 +128,41 @@ MEMB(connections, struct connection, 16);
 #define MEMB(name, structure, num) \
         static char CC_CONCAT(name,_memb_count)[num]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
+        MEMB_FREE_LIST_DECLARE(name, num) \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_count), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          (void *)CC_CONCAT(name,_memb_mem) \
+                                          MEMB_FREE_LIST_INIT(name) \
+                                          MEMB_STATS_INIT(name)}
 
 struct memb {
   unsigned short size;
   unsigned short num;
   char *count;
   void *mem;
+#if MEMB_FREE_LIST
+  /* The index of the next free chunk, for each free chunk */
+  unsigned short *next;
+#endif /* MEMB_FREE_LIST */
+#if MEMB_STATS
+  const char *name;
+#endif /* MEMB_STATS */
+#if MEMB_FREE_LIST
+  /* The first free chunk plus one, or zero if the list is empty */
+  unsigned short free;
+  /* Chunks at or above this index have never been allocated, and are
+     not on the free list */
+  unsigned short unused;
+#endif /* MEMB_FREE_LIST */
+#if MEMB_FREE_LIST || MEMB_STATS
+  unsigned short used;
+#endif /* MEMB_FREE_LIST || MEMB_STATS */
+#if MEMB_STATS
+  unsigned short max_used;
+  unsigned short failed;
+  struct memb *list_next;
+  char listed;
+#endif /* MEMB_STATS */
 };
 
 /**
@@ -132,6 +197,17 @@ int memb_inmemb(struct memb *m, void *ptr);
 
 int  memb_numfree(struct memb *m);
 
+#if MEMB_STATS
+/**
+ * Get the first memory block on the list of initialized memory blocks.
+ *
+ * \return The memory block that was most recently initialized with
+ * memb_init(), or NULL. The rest of the list follows the list_next
+ * fields.
+ */
+struct memb *memb_list_head(void);
+#endif /* MEMB_STATS */
+
 /** @} */
 /** @} */
 
@@ -47,6 +47,7 @@
 #include "mmem.h"
 #include "list.h"
 #include "contiki-conf.h"
+#include <stdint.h>
 #include <string.h>
 
 #ifdef MMEM_CONF_SIZE
@@ -55,9 +56,128 @@
 #define MMEM_SIZE 4096
 #endif
 
-LIST(mmemlist);
 unsigned int avail_memory;
+
+#if MMEM_SIZE_CLASSES
+/*
+ * Every block starts with a header that holds its own size and the
+ * size of the block physically before it, so that neighbours can be
+ * merged in constant time when a block is freed. Free blocks are kept
+ * on one doubly linked list per power-of-two size class, and a bitmap
+ * tells which of the lists are non-empty.
+ */
+struct block {
+  unsigned int size;      /* Including header, FREE_FLAG set when free */
+  unsigned int prev_size; /* Zero for the first block */
+};
+
+struct free_block {
+  struct block hdr;
+  struct free_block *next;
+  struct free_block *prev;
+};
+
+#define FREE_FLAG      1
+#define ALIGNMENT      sizeof(struct free_block *)
+#define ROUND_UP(n)    (((n) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+#define HEADER_SIZE    ROUND_UP(sizeof(struct block))
+#define MIN_BLOCK      ROUND_UP(sizeof(struct free_block))
+#define ARENA_SIZE     (MMEM_SIZE & ~(ALIGNMENT - 1))
+#define NUM_CLASSES    32
+
+#define BLOCK_SIZE(b)  ((b)->size & ~FREE_FLAG)
+#define IS_FREE(b)     ((b)->size & FREE_FLAG)
+#define AT(b, off)     ((struct block *)((char *)(b) + (off)))
+#define ARENA_END      AT(memory.bytes, ARENA_SIZE)
+
+static union {
+  char bytes[MMEM_SIZE];
+  struct free_block *align;
+} memory;
+
+static struct free_block *free_lists[NUM_CLASSES];
+static uint32_t nonempty;
+/*---------------------------------------------------------------------------*/
+static uint8_t
+size_class(unsigned int size)
+{
+  uint8_t c;
+
+  for(c = 0; size > 1; c++) {
+    size >>= 1;
+  }
+  return c;
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert_free(struct block *b, unsigned int size)
+{
+  struct free_block *f = (struct free_block *)b;
+  uint8_t c = size_class(size);
+
+  b->size = size | FREE_FLAG;
+  f->prev = NULL;
+  f->next = free_lists[c];
+  if(f->next != NULL) {
+    f->next->prev = f;
+  }
+  free_lists[c] = f;
+  nonempty |= (uint32_t)1 << c;
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_free(struct block *b)
+{
+  struct free_block *f = (struct free_block *)b;
+  uint8_t c = size_class(BLOCK_SIZE(b));
+
+  if(f->prev != NULL) {
+    f->prev->next = f->next;
+  } else {
+    free_lists[c] = f->next;
+    if(f->next == NULL) {
+      nonempty &= ~((uint32_t)1 << c);
+    }
+  }
+  if(f->next != NULL) {
+    f->next->prev = f->prev;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct block *
+find_free(unsigned int size)
+{
+  struct free_block *f;
+  uint32_t mask;
+  uint8_t c;
+
+  /* Every block in a class above the one holding size is large
+     enough, so the first non-empty such list will do. */
+  c = size_class(size);
+  if(((unsigned int)1 << c) < size) {
+    c++;
+  }
+  mask = c < NUM_CLASSES ? nonempty & ~(((uint32_t)1 << c) - 1) : 0;
+  if(mask != 0) {
+    for(c = 0; (mask & 1) == 0; c++) {
+      mask >>= 1;
+    }
+    return &free_lists[c]->hdr;
+  }
+
+  /* Otherwise, only the class of size itself may hold a block that
+     fits. */
+  for(f = free_lists[size_class(size)]; f != NULL; f = f->next) {
+    if(BLOCK_SIZE(&f->hdr) >= size) {
+      return &f->hdr;
+    }
+  }
+  return NULL;
+}
+#else /* MMEM_SIZE_CLASSES */
+LIST(mmemlist);
 static char memory[MMEM_SIZE];
+#endif /* MMEM_SIZE_CLASSES */
 
 /*---------------------------------------------------------------------------*/
 /**
@@ -79,6 +199,47 @@ static char memory[MMEM_SIZE];
  *             allocated memory.
  *
  */
+#if MMEM_SIZE_CLASSES
+int
+mmem_alloc(struct mmem *m, unsigned int size)
+{
+  struct block *b;
+  unsigned int need;
+  unsigned int have;
+
+  if(size > ARENA_SIZE - HEADER_SIZE) {
+    return 0;
+  }
+  need = ROUND_UP(size + HEADER_SIZE);
+  if(need < MIN_BLOCK) {
+    need = MIN_BLOCK;
+  }
+
+  b = find_free(need);
+  if(b == NULL) {
+    return 0;
+  }
+  remove_free(b);
+
+  /* Give the tail back if it is large enough to be a block. */
+  have = BLOCK_SIZE(b);
+  if(have - need >= MIN_BLOCK) {
+    AT(b, need)->prev_size = need;
+    if(AT(b, have) != ARENA_END) {
+      AT(b, have)->prev_size = have - need;
+    }
+    insert_free(AT(b, need), have - need);
+    have = need;
+  }
+  b->size = have;
+  avail_memory -= have;
+
+  m->ptr = AT(b, HEADER_SIZE);
+  m->size = size;
+  m->next = NULL;
+  return 1;
+}
+#else /* MMEM_SIZE_CLASSES */
 int
 mmem_alloc(struct mmem *m, unsigned int size)
 {
@@ -105,6 +266,7 @@ mmem_alloc(struct mmem *m, unsigned int size)
      memory. */
   return 1;
 }
+#endif /* MMEM_SIZE_CLASSES */
 /*---------------------------------------------------------------------------*/
 /**
  * \brief      Deallocate a managed memory block
@@ -115,6 +277,35 @@ mmem_alloc(struct mmem *m, unsigned int size)
  *             previously has been allocated with mmem_alloc().
  *
  */
+#if MMEM_SIZE_CLASSES
+void
+mmem_free(struct mmem *m)
+{
+  struct block *b;
+  struct block *n;
+  unsigned int size;
+
+  b = AT(m->ptr, -(int)HEADER_SIZE);
+  size = BLOCK_SIZE(b);
+  avail_memory += size;
+
+  /* Merge with the free neighbours on both sides. */
+  n = AT(b, size);
+  if(n != ARENA_END && IS_FREE(n)) {
+    remove_free(n);
+    size += BLOCK_SIZE(n);
+  }
+  if(b->prev_size != 0 && IS_FREE(AT(b, -(int)b->prev_size))) {
+    b = AT(b, -(int)b->prev_size);
+    remove_free(b);
+    size += BLOCK_SIZE(b);
+  }
+  if(AT(b, size) != ARENA_END) {
+    AT(b, size)->prev_size = size;
+  }
+  insert_free(b, size);
+}
+#else /* MMEM_SIZE_CLASSES */
 void
 mmem_free(struct mmem *m)
 {
@@ -138,6 +329,7 @@ mmem_free(struct mmem *m)
   /* Remove the memory block from the list. */
   list_remove(mmemlist, m);
 }
+#endif /* MMEM_SIZE_CLASSES */
 /*---------------------------------------------------------------------------*/
 /**
  * \brief      Initialize the managed memory module
@@ -155,10 +347,55 @@ mmem_init(void)
   if(inited) {
     return;
   }
+#if MMEM_SIZE_CLASSES
+  memset(free_lists, 0, sizeof(free_lists));
+  nonempty = 0;
+  ((struct block *)memory.bytes)->prev_size = 0;
+  insert_free((struct block *)memory.bytes, ARENA_SIZE);
+  avail_memory = ARENA_SIZE;
+#else /* MMEM_SIZE_CLASSES */
   list_init(mmemlist);
   avail_memory = MMEM_SIZE;
+#endif /* MMEM_SIZE_CLASSES */
   inited = 1;
 }
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief      Report occupancy and fragmentation of the managed memory
+ * \param stats Filled in with the current figures
+ *
+ *             This function walks all blocks and is meant for
+ *             diagnostics, not for use on a fast path.
+ */
+void
+mmem_stats(struct mmem_stats *stats)
+{
+#if MMEM_SIZE_CLASSES
+  struct block *b;
+  unsigned int size;
+
+  memset(stats, 0, sizeof(*stats));
+  for(b = (struct block *)memory.bytes; b != ARENA_END; b = AT(b, size)) {
+    size = BLOCK_SIZE(b);
+    if(IS_FREE(b)) {
+      stats->free_bytes += size;
+      stats->free_blocks++;
+      if(size - HEADER_SIZE > stats->largest_free) {
+        stats->largest_free = size - HEADER_SIZE;
+      }
+    } else {
+      stats->used_bytes += size;
+      stats->used_blocks++;
+    }
+  }
+#else /* MMEM_SIZE_CLASSES */
+  stats->used_bytes = MMEM_SIZE - avail_memory;
+  stats->used_blocks = list_length(mmemlist);
+  stats->free_bytes = avail_memory;
+  stats->free_blocks = avail_memory > 0;
+  stats->largest_free = avail_memory;
+#endif /* MMEM_SIZE_CLASSES */
+}
+/*---------------------------------------------------------------------------*/
 
 /** @} */
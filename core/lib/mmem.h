@@ -44,6 +44,11 @@
  * stays in place. Therefore, a level of indirection is used: access
  * to allocated memory must always be done using a special macro.
  *
+ * If MMEM_CONF_SIZE_CLASSES is set, blocks are instead carved out of
+ * segregated power-of-two free lists and never move. Allocation and
+ * deallocation then take constant time, at the cost of some
+ * fragmentation, which can be inspected with mmem_stats().
+ *
  * \note This module has not been heavily tested.
  * @{
  */
@@ -59,6 +64,14 @@
 #ifndef MMEM_H_
 #define MMEM_H_
 
+#include "contiki-conf.h"
+
+#ifdef MMEM_CONF_SIZE_CLASSES
+#define MMEM_SIZE_CLASSES MMEM_CONF_SIZE_CLASSES
+#else
+#define MMEM_SIZE_CLASSES 0
+#endif
+
 /*---------------------------------------------------------------------------*/
 /**
  * \brief      Get a pointer to the managed memory
@@ -83,9 +96,23 @@ struct mmem {
 /* XXX: tagga minne med "interrupt usage", vilke gr att man r
    speciellt varsam under free(). */
 
+/**
+ * Occupancy and fragmentation of the managed memory, as reported by
+ * mmem_stats(). The ratio of largest_free to free_bytes shows how
+ * fragmented the free memory is.
+ */
+struct mmem_stats {
+  unsigned int used_bytes;    /**< Bytes handed out, including overhead */
+  unsigned int used_blocks;   /**< Number of allocated blocks */
+  unsigned int free_bytes;    /**< Bytes available for allocation */
+  unsigned int free_blocks;   /**< Number of free blocks */
+  unsigned int largest_free;  /**< Largest block that could be allocated */
+};
+
 int  mmem_alloc(struct mmem *m, unsigned int size);
 void mmem_free(struct mmem *);
 void mmem_init(void);
+void mmem_stats(struct mmem_stats *stats);
 
 #endif /* MMEM_H_ */
 
@@ -111,6 +111,15 @@ enum {
   PACKET_INPUT
 };
 
+#if TCPIP_INPUT_QUEUE
+/* Received packets waiting for the stack, in a ring */
+static struct {
+  uint16_t len;
+  uint8_t buf[UIP_BUFSIZE];
+} input_queue[TCPIP_INPUT_QUEUE];
+static uint8_t input_head, input_count;
+#endif /* TCPIP_INPUT_QUEUE */
+
 /* Called on IP packet output. */
 #if NETSTACK_CONF_WITH_IPV6
 
@@ -525,6 +534,49 @@ tcpip_input(void)
   uip_clear_buf();
 }
 /*---------------------------------------------------------------------------*/
+#if TCPIP_INPUT_QUEUE
+uint8_t *
+tcpip_input_get_buf(void)
+{
+  if(input_count == TCPIP_INPUT_QUEUE) {
+    return NULL;
+  }
+  return input_queue[(input_head + input_count) % TCPIP_INPUT_QUEUE].buf;
+}
+/*---------------------------------------------------------------------------*/
+void
+tcpip_input_put_buf(uint16_t len)
+{
+  if(input_count == TCPIP_INPUT_QUEUE) {
+    return;
+  }
+  input_queue[(input_head + input_count) % TCPIP_INPUT_QUEUE].len = len;
+  if(input_count++ == 0) {
+    process_poll(&tcpip_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+pollhandler(void)
+{
+  int budget;
+
+  for(budget = TCPIP_INPUT_BUDGET; budget > 0 && input_count > 0; budget--) {
+    uip_len = input_queue[input_head].len;
+    memcpy(uip_buf, input_queue[input_head].buf, uip_len);
+    input_head = (input_head + 1) % TCPIP_INPUT_QUEUE;
+    input_count--;
+    packet_input();
+    uip_clear_buf();
+  }
+
+  if(input_count > 0) {
+    /* Let other processes run before the rest of the queue */
+    process_poll(&tcpip_process);
+  }
+}
+#endif /* TCPIP_INPUT_QUEUE */
+/*---------------------------------------------------------------------------*/
 #if NETSTACK_CONF_WITH_IPV6
 void
 tcpip_ipv6_output(void)
@@ -811,8 +863,15 @@ tcpip_uipcall(void)
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(tcpip_process, ev, data)
 {
+#if TCPIP_INPUT_QUEUE
+  PROCESS_POLLHANDLER(pollhandler());
+#endif /* TCPIP_INPUT_QUEUE */
+
   PROCESS_BEGIN();
 
+  /* Network events are delivered before application events. */
+  process_set_priority(&tcpip_process, PROCESS_PRIORITY_HIGH);
+
 #if UIP_TCP
   {
     unsigned char i;
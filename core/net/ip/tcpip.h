@@ -336,6 +336,47 @@ CCIF extern process_event_t tcpip_event;
  */
 CCIF void tcpip_input(void);
 
+/* Number of received packets that drivers can queue for the TCP/IP
+   stack with tcpip_input_get_buf() and tcpip_input_put_buf(), each
+   taking UIP_BUFSIZE bytes. The stack processes the queue in batches
+   instead of being called for each packet. */
+#ifdef TCPIP_CONF_INPUT_QUEUE
+#define TCPIP_INPUT_QUEUE TCPIP_CONF_INPUT_QUEUE
+#else /* TCPIP_CONF_INPUT_QUEUE */
+#define TCPIP_INPUT_QUEUE 0
+#endif /* TCPIP_CONF_INPUT_QUEUE */
+
+/* Maximum number of queued packets processed before letting other
+   processes run */
+#ifdef TCPIP_CONF_INPUT_BUDGET
+#define TCPIP_INPUT_BUDGET TCPIP_CONF_INPUT_BUDGET
+#else /* TCPIP_CONF_INPUT_BUDGET */
+#define TCPIP_INPUT_BUDGET TCPIP_INPUT_QUEUE
+#endif /* TCPIP_CONF_INPUT_BUDGET */
+
+#if TCPIP_INPUT_QUEUE
+/**
+ * \brief      Get a buffer for an incoming packet
+ * \return     A buffer of UIP_BUFSIZE bytes, or NULL if the queue is full
+ *
+ *             A network device driver reads the packet into the
+ *             buffer, laid out as in uip_buf, and queues it with
+ *             tcpip_input_put_buf(). The same buffer is returned
+ *             until it is queued, so a driver can skip packets that
+ *             are not for the TCP/IP stack by not queueing them.
+ */
+uint8_t *tcpip_input_get_buf(void);
+
+/**
+ * \brief      Queue the packet in the buffer from tcpip_input_get_buf()
+ * \param len  The length of the packet, as uip_len would be
+ *
+ *             The TCP/IP stack processes up to TCPIP_CONF_INPUT_BUDGET
+ *             queued packets each time it runs.
+ */
+void tcpip_input_put_buf(uint16_t len);
+#endif /* TCPIP_INPUT_QUEUE */
+
 /**
  * \brief Output packet to layer 2
  * The eventual parameter is the MAC address of the destination.
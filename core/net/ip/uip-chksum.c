@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Internet checksum computation and incremental update.
+ */
+
+#include "net/ip/uip.h"
+#include "net/ip/uip-chksum.h"
+
+#if UIP_CHKSUM_WIDE
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif /* __SSE2__ */
+#endif /* UIP_CHKSUM_WIDE */
+
+#if UIP_CHKSUM_WIDE
+/*---------------------------------------------------------------------------*/
+/* Sum the data as 16-bit words in host byte order. The ones-complement
+   sum does not depend on the byte order, except for the result coming
+   out byte swapped on little-endian CPUs. Loads go through memcpy() so
+   that the data needs no particular alignment. */
+static uint16_t
+sum_words(const uint8_t *data, uint16_t len)
+{
+  uint64_t acc;
+  uint32_t w[4];
+  uint16_t h;
+
+  acc = 0;
+#ifdef __SSE2__
+  if(len >= 32) {
+    /* Widen the 16-bit words into 32-bit lanes. With at most 4096
+       blocks in a packet, the lanes cannot overflow. */
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = zero;
+    __m128i hi = zero;
+    __m128i v;
+
+    while(len >= 16) {
+      v = _mm_loadu_si128((const __m128i *)data);
+      lo = _mm_add_epi32(lo, _mm_unpacklo_epi16(v, zero));
+      hi = _mm_add_epi32(hi, _mm_unpackhi_epi16(v, zero));
+      data += 16;
+      len -= 16;
+    }
+    _mm_storeu_si128((__m128i *)w, _mm_add_epi32(lo, hi));
+    acc = (uint64_t)w[0] + w[1] + w[2] + w[3];
+  }
+#endif /* __SSE2__ */
+
+  while(len >= 16) {
+    memcpy(w, data, 16);
+    acc += (uint64_t)w[0] + w[1] + w[2] + w[3];
+    data += 16;
+    len -= 16;
+  }
+  while(len >= 4) {
+    memcpy(w, data, 4);
+    acc += w[0];
+    data += 4;
+    len -= 4;
+  }
+  if(len >= 2) {
+    memcpy(&h, data, 2);
+    acc += h;
+    data += 2;
+    len -= 2;
+  }
+  if(len > 0) {
+    /* Pad the last byte with a zero byte */
+    h = 0;
+    memcpy(&h, data, 1);
+    acc += h;
+  }
+
+  while(acc >> 16) {
+    acc = (acc & 0xffff) + (acc >> 16);
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint32_t t;
+
+  t = sum_words(data, len);
+#if UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN
+  t = ((t & 0xff) << 8) | (t >> 8);
+#endif /* UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN */
+  t += sum;
+
+  /* Return sum in host byte order. */
+  return (t & 0xffff) + (t >> 16);
+}
+#else /* UIP_CHKSUM_WIDE */
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  const uint8_t *dataptr;
+  const uint8_t *last_byte;
+
+  dataptr = data;
+  last_byte = data + len - 1;
+
+  while(dataptr < last_byte) {   /* At least two more bytes */
+    t = (dataptr[0] << 8) + dataptr[1];
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+    dataptr += 2;
+  }
+
+  if(dataptr == last_byte) {
+    t = (dataptr[0] << 8) + 0;
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+  }
+
+  /* Return sum in host byte order. */
+  return sum;
+}
+#endif /* UIP_CHKSUM_WIDE */
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_update(uint16_t chksum, uint16_t old_val, uint16_t new_val)
+{
+  uint32_t sum;
+
+  /* RFC 1624, eqn. 3: HC' = ~(~HC + ~m + m') */
+  sum = (uint16_t)~chksum;
+  sum += (uint16_t)~old_val;
+  sum += new_val;
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  return ~sum;
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Internet checksum computation and incremental update.
+ */
+
+#ifndef UIP_CHKSUM_H_
+#define UIP_CHKSUM_H_
+
+#include "contiki-conf.h"
+
+/* Sum the data 32 bits at a time into a wide accumulator instead of
+   16 bits at a time, and 128 bits at a time with SSE2 where the
+   compiler provides it. Meant for 32-bit and larger CPUs. */
+#ifdef UIP_CONF_CHKSUM_WIDE
+#define UIP_CHKSUM_WIDE UIP_CONF_CHKSUM_WIDE
+#else /* UIP_CONF_CHKSUM_WIDE */
+#define UIP_CHKSUM_WIDE 0
+#endif /* UIP_CONF_CHKSUM_WIDE */
+
+/**
+ * \brief      Add data to a ones-complement sum
+ * \param sum  The sum so far, in host byte order
+ * \param data The data, in network byte order
+ * \param len  The length of the data, in bytes
+ * \return     The new sum, in host byte order
+ *
+ *             An odd length is padded with a zero byte, so only the
+ *             last block of data added to a sum may have one.
+ *
+ */
+uint16_t uip_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * \brief      Update a checksum after rewriting part of the data
+ * \param chksum The checksum field, in host byte order
+ * \param old_val The ones-complement sum of the old data
+ * \param new_val The ones-complement sum of the new data
+ * \return     The updated checksum, in host byte order
+ *
+ *             This function updates a checksum incrementally as in
+ *             RFC 1624, without summing the unchanged data again. For
+ *             a single rewritten 16-bit field, old_val and new_val
+ *             are the old and new values of the field. For longer
+ *             fields, they are computed with uip_chksum_add().
+ *
+ */
+uint16_t uip_chksum_update(uint16_t chksum, uint16_t old_val,
+                           uint16_t new_val);
+
+#endif /* UIP_CHKSUM_H_ */
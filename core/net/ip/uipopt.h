@@ -579,6 +579,7 @@ void uip_log(char *msg);
 
 /**
  * If we use IPHC compression, how many address contexts do we support
+ * (at most 16)
  */
 #ifndef SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS 
 #define SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS 1
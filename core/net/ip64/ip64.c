@@ -65,6 +65,7 @@
 #include "contiki-net.h"
 
 #include "net/ip/uip-debug.h"
+#include "net/ip/uip-chksum.h"
 
 #include <string.h> /* for memcpy() */
 #include <stdio.h> /* for printf() */
@@ -269,42 +270,11 @@ ip64_set_ipv6_address(const uip_ip6addr_t *addr)
 }
 /*---------------------------------------------------------------------------*/
 static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
-{
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while(dataptr < last_byte) {	/* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
-    dataptr += 2;
-  }
-
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;		/* carry */
-    }
-  }
-
-  /* Return sum in host byte order. */
-  return sum;
-}
-/*---------------------------------------------------------------------------*/
-static uint16_t
 ipv4_checksum(struct ipv4_hdr *hdr)
 {
   uint16_t sum;
 
-  sum = chksum(0, (uint8_t *)hdr, IPV4_HDRLEN);
+  sum = uip_chksum_add(0, (uint8_t *)hdr, IPV4_HDRLEN);
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
 /*---------------------------------------------------------------------------*/
@@ -323,14 +293,14 @@ ipv4_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
     /* IP protocol and length fields. This addition cannot carry. */
     sum = transport_layer_len + proto;
     /* Sum IP source and destination addresses. */
-    sum = chksum(sum, (uint8_t *)&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t));
+    sum = uip_chksum_add(sum, (uint8_t *)&v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t));
   } else {
     /* ping replies' checksums are calculated over the icmp-part only */
     sum = 0;
   }
 
   /* Sum transport layer header and data. */
-  sum = chksum(sum, &packet[IPV4_HDRLEN], transport_layer_len);
+  sum = uip_chksum_add(sum, &packet[IPV4_HDRLEN], transport_layer_len);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -349,15 +319,35 @@ ipv6_transport_checksum(const uint8_t *packet, uint16_t len, uint8_t proto)
   /* IP protocol and length fields. This addition cannot carry. */
   sum = transport_layer_len + proto;
   /* Sum IP source and destination addresses. */
-  sum = chksum(sum, (uint8_t *)&v6hdr->srcipaddr, sizeof(uip_ip6addr_t));
-  sum = chksum(sum, (uint8_t *)&v6hdr->destipaddr, sizeof(uip_ip6addr_t));
+  sum = uip_chksum_add(sum, (uint8_t *)&v6hdr->srcipaddr, sizeof(uip_ip6addr_t));
+  sum = uip_chksum_add(sum, (uint8_t *)&v6hdr->destipaddr, sizeof(uip_ip6addr_t));
 
   /* Sum transport layer header and data. */
-  sum = chksum(sum, &packet[IPV6_HDRLEN], transport_layer_len);
+  sum = uip_chksum_add(sum, &packet[IPV6_HDRLEN], transport_layer_len);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
 /*---------------------------------------------------------------------------*/
+/* Update a TCP or UDP checksum for the translated pseudo-header
+   addresses and the remapped port, as in RFC 1624, instead of summing
+   the whole packet again. The pseudo-header length and protocol are
+   the same for IPv4 and IPv6. The checksum field and the ports are in
+   network byte order. */
+static uint16_t
+translate_checksum(uint16_t chksum,
+                   const void *oldaddrs, uint16_t oldlen,
+                   const void *newaddrs, uint16_t newlen,
+                   uint16_t oldport, uint16_t newport)
+{
+  uint16_t sum;
+
+  sum = uip_chksum_update(uip_ntohs(chksum),
+                          uip_chksum_add(0, oldaddrs, oldlen),
+                          uip_chksum_add(0, newaddrs, newlen));
+  sum = uip_chksum_update(sum, uip_ntohs(oldport), uip_ntohs(newport));
+  return uip_htons(sum);
+}
+/*---------------------------------------------------------------------------*/
 int
 ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
 	  uint8_t *resultpacket)
@@ -369,6 +359,8 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   struct icmpv4_hdr *icmpv4hdr;
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv6len, ipv4len;
+  uint16_t srcport;
+  int rewritten;
   struct ip64_addrmap_entry *m;
 
   v6hdr = (struct ipv6_hdr *)ipv6packet;
@@ -391,6 +383,8 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
   tcphdr = (struct tcp_hdr *)&resultpacket[IPV4_HDRLEN];
   icmpv4hdr = (struct icmpv4_hdr *)&resultpacket[IPV4_HDRLEN];
   icmpv6hdr = (struct icmpv6_hdr *)&ipv6packet[IPV6_HDRLEN];
+  srcport = udphdr->srcport;
+  rewritten = 0;
 
   /* Translate the IPv6 header into an IPv4 header. */
 
@@ -425,13 +419,14 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
     PRINTF("ip64_6to4: TCP header\n");
     v4hdr->proto = IP_PROTO_TCP;
 
-    /* Compute and check the TCP checksum - since we're going to
-       recompute it ourselves, we must ensure that it was correct in
-       the first place. */
+#if DEBUG
+    /* The checksum is updated rather than recomputed, so a bad
+       checksum stays bad in the IPv4 packet. */
     if(ipv6_transport_checksum(ipv6packet, ipv6len,
                                IP_PROTO_TCP) != 0xffff) {
-      PRINTF("Bad TCP checksum, dropping packet\n");
+      PRINTF("Bad TCP checksum\n");
     }
+#endif /* DEBUG */
 
     break;
 
@@ -446,14 +441,14 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
                       ipv6len - IPV6_HDRLEN - sizeof(struct udp_hdr),
                       (uint8_t *)udphdr + sizeof(struct udp_hdr),
                       BUFSIZE - IPV4_HDRLEN - sizeof(struct udp_hdr));
+      rewritten = 1;
     }
-    /* Compute and check the UDP checksum - since we're going to
-       recompute it ourselves, we must ensure that it was correct in
-       the first place. */
+#if DEBUG
     if(ipv6_transport_checksum(ipv6packet, ipv6len,
                                IP_PROTO_UDP) != 0xffff) {
-      PRINTF("Bad UDP checksum, dropping packet\n");
+      PRINTF("Bad UDP checksum\n");
     }
+#endif /* DEBUG */
     break;
 
   case IP_PROTO_ICMPV6:
@@ -619,14 +614,22 @@ ip64_6to4(const uint8_t *ipv6packet, const uint16_t ipv6packet_len,
      field. */
   switch(v4hdr->proto) {
   case IP_PROTO_TCP:
-    tcphdr->tcpchksum = 0;
-    tcphdr->tcpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						  IP_PROTO_TCP));
+    tcphdr->tcpchksum = translate_checksum(tcphdr->tcpchksum,
+                                           &v6hdr->srcipaddr, 2 * sizeof(uip_ip6addr_t),
+                                           &v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t),
+                                           srcport, tcphdr->srcport);
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
-    udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
-						  IP_PROTO_UDP));
+    if(rewritten) {
+      udphdr->udpchksum = 0;
+      udphdr->udpchksum = ~(ipv4_transport_checksum(resultpacket, ipv4len,
+                                                    IP_PROTO_UDP));
+    } else {
+      udphdr->udpchksum = translate_checksum(udphdr->udpchksum,
+                                             &v6hdr->srcipaddr, 2 * sizeof(uip_ip6addr_t),
+                                             &v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t),
+                                             srcport, udphdr->srcport);
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
@@ -658,6 +661,8 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
   struct icmpv4_hdr *icmpv4hdr;
   struct icmpv6_hdr *icmpv6hdr;
   uint16_t ipv4len, ipv6len, ipv6_packet_len;
+  uint16_t destport;
+  int rewritten;
   struct ip64_addrmap_entry *m;
 
   v6hdr = (struct ipv6_hdr *)resultpacket;
@@ -689,6 +694,8 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
   tcphdr = (struct tcp_hdr *)&resultpacket[IPV6_HDRLEN];
   icmpv4hdr = (struct icmpv4_hdr *)&ipv4packet[IPV4_HDRLEN];
   icmpv6hdr = (struct icmpv6_hdr *)&resultpacket[IPV6_HDRLEN];
+  destport = udphdr->destport;
+  rewritten = 0;
 
   ipv6len = ipv4len - IPV4_HDRLEN + IPV6_HDRLEN;
   ipv6_packet_len = ipv6len - IPV6_HDRLEN;
@@ -741,7 +748,7 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
       v6hdr->len[0] = ipv6_packet_len >> 8;
       v6hdr->len[1] = ipv6_packet_len & 0xff;
       ipv6len = ipv6_packet_len + IPV6_HDRLEN;
-
+      rewritten = 1;
     }
     break;
 
@@ -854,16 +861,24 @@ ip64_4to6(const uint8_t *ipv4packet, const uint16_t ipv4packet_len,
      field. */
   switch(v6hdr->nxthdr) {
   case IP_PROTO_TCP:
-    tcphdr->tcpchksum = 0;
-    tcphdr->tcpchksum = ~(ipv6_transport_checksum(resultpacket,
-						  ipv6len,
-						  IP_PROTO_TCP));
+    tcphdr->tcpchksum = translate_checksum(tcphdr->tcpchksum,
+                                           &v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t),
+                                           &v6hdr->srcipaddr, 2 * sizeof(uip_ip6addr_t),
+                                           destport, tcphdr->destport);
     break;
   case IP_PROTO_UDP:
-    udphdr->udpchksum = 0;
-    udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
-						  ipv6len,
-						  IP_PROTO_UDP));
+    /* A zero UDP checksum means none in IPv4, but is mandatory in IPv6 */
+    if(rewritten || udphdr->udpchksum == 0) {
+      udphdr->udpchksum = 0;
+      udphdr->udpchksum = ~(ipv6_transport_checksum(resultpacket,
+                                                    ipv6len,
+                                                    IP_PROTO_UDP));
+    } else {
+      udphdr->udpchksum = translate_checksum(udphdr->udpchksum,
+                                             &v4hdr->srcipaddr, 2 * sizeof(uip_ip4addr_t),
+                                             &v6hdr->srcipaddr, 2 * sizeof(uip_ip6addr_t),
+                                             destport, udphdr->destport);
+    }
     if(udphdr->udpchksum == 0) {
       udphdr->udpchksum = 0xffff;
     }
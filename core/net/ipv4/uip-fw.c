@@ -58,6 +58,7 @@
 
 #include "net/ip/uip.h"
 #include "net/ip/uip_arch.h"
+#include "net/ip/uip-chksum.h"
 #include "net/ipv4/uip-fw.h"
 #ifdef AODV_COMPLIANCE
 #include "net/ipv4/uaodv-def.h"
@@ -464,12 +465,10 @@ uip_fw_forward(void)
   /* Decrement the TTL (time-to-live) value in the IP header */
   BUF->ttl = BUF->ttl - 1;
   
-  /* Update the IP checksum. */
-  if(BUF->ipchksum >= UIP_HTONS(0xffff - 0x0100)) {
-    BUF->ipchksum = BUF->ipchksum + UIP_HTONS(0x0100) + 1;
-  } else {
-    BUF->ipchksum = BUF->ipchksum + UIP_HTONS(0x0100);
-  }
+  /* Update the IP checksum for the TTL and protocol word. */
+  BUF->ipchksum = uip_htons(uip_chksum_update(uip_ntohs(BUF->ipchksum),
+                                              ((BUF->ttl + 1) << 8) | BUF->proto,
+                                              (BUF->ttl << 8) | BUF->proto));
 
   if(uip_len > 0) {
     uip_appdata = &uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN];
@@ -66,6 +66,7 @@
 #include "net/ip/tcpip.h"
 #include "net/ip/uip.h"
 #include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-icmp6.h"
 #include "net/rime/rime.h"
 #include "net/ipv6/sicslowpan.h"
 #include "net/netstack.h"
@@ -287,6 +288,31 @@ struct sicslowpan_frag_buf {
 
 static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
 
+#if SICSLOWPAN_FRAG_FORWARD
+#if !UIP_CONF_ROUTER
+#error "SICSLOWPAN_CONF_FRAG_FORWARD needs UIP_CONF_ROUTER"
+#endif /* !UIP_CONF_ROUTER */
+
+/* A datagram whose fragments are forwarded as they arrive */
+struct sicslowpan_frag_fwd {
+  /** The sender and the tag of the incoming fragments */
+  linkaddr_t sender;
+  uint16_t tag;
+  /** The next hop and the tag of the outgoing fragments */
+  linkaddr_t nexthop;
+  uint16_t out_tag;
+  /** Total length of the datagram, zero if the entry is unused */
+  uint16_t size;
+  /** Length of the datagram forwarded so far */
+  uint16_t forwarded_len;
+  struct timer lifetime;
+};
+
+static struct sicslowpan_frag_fwd frag_fwd[SICSLOWPAN_FRAG_FORWARD];
+
+struct sicslowpan_frag_stats sicslowpan_frag_stats;
+#endif /* SICSLOWPAN_FRAG_FORWARD */
+
 /*---------------------------------------------------------------------------*/
 static int
 clear_fragments(uint8_t frag_info_index)
@@ -492,11 +518,65 @@ set_packet_attrs(void)
  */
 
 /** Addresses contexts for IPHC. */
+#if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 16
+#error "IPHC supports at most 16 address contexts"
+#endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 16 */
+
 #if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+/* Context i has number i, so contexts are found by number directly */
 static struct sicslowpan_addr_context
 addr_contexts[SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS];
 #endif
 
+/* Find address contexts by prefix through an open-addressed hash
+   index instead of comparing the prefix of every context */
+#ifdef SICSLOWPAN_CONF_ADDR_CONTEXT_HASH
+#define SICSLOWPAN_ADDR_CONTEXT_HASH SICSLOWPAN_CONF_ADDR_CONTEXT_HASH
+#else /* SICSLOWPAN_CONF_ADDR_CONTEXT_HASH */
+#define SICSLOWPAN_ADDR_CONTEXT_HASH 0
+#endif /* SICSLOWPAN_CONF_ADDR_CONTEXT_HASH */
+
+#if SICSLOWPAN_ADDR_CONTEXT_HASH && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+/* Twice the number of contexts, rounded to a power of two */
+#define CONTEXT_INDEX_SIZE 32
+/* Context number + 1 for each slot, 0 if the slot is empty */
+static uint8_t context_index[CONTEXT_INDEX_SIZE];
+#endif /* SICSLOWPAN_ADDR_CONTEXT_HASH && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+
+/* Number of flows whose compressed header is kept, so that the next
+   packets of the flow only need the UDP checksum filled in. The
+   node's own link-layer address must not change once packets have
+   been sent. */
+#ifdef SICSLOWPAN_CONF_IPHC_CACHE
+#define SICSLOWPAN_IPHC_CACHE SICSLOWPAN_CONF_IPHC_CACHE
+#else /* SICSLOWPAN_CONF_IPHC_CACHE */
+#define SICSLOWPAN_IPHC_CACHE 0
+#endif /* SICSLOWPAN_CONF_IPHC_CACHE */
+
+#if SICSLOWPAN_IPHC_CACHE
+/* Longest IPHC header with LOWPAN_UDP, without the UDP checksum:
+   IPHC and CID, traffic class and flow label, next header, hop
+   limit, addresses and ports */
+#define IPHC_CACHE_HDR_LEN (3 + 4 + 1 + 1 + 16 + 16 + 5)
+
+/** \brief The compressed header of a flow */
+struct iphc_cache_entry {
+  /** The IPv6 header of the flow, the payload length is ignored */
+  uint8_t ip[UIP_IPH_LEN];
+  /** The UDP ports of the flow */
+  uint8_t ports[4];
+  /** The link-layer destination the header was compressed for */
+  linkaddr_t link_dest;
+  /** The compressed header, without the UDP checksum */
+  uint8_t hdr[IPHC_CACHE_HDR_LEN];
+  /** Length of the compressed header, zero if the entry is unused */
+  uint8_t hdr_len;
+  uint8_t uncomp_hdr_len;
+};
+
+static struct iphc_cache_entry iphc_cache[SICSLOWPAN_IPHC_CACHE];
+#endif /* SICSLOWPAN_IPHC_CACHE */
+
 /** pointer to an address context. */
 static struct sicslowpan_addr_context *context;
 
@@ -536,12 +616,55 @@ static const uint8_t ttl_values[] = {0, 1, 64, 255};
 /** \name IPHC related functions
  * @{                                                                 */
 /*--------------------------------------------------------------------*/
+#if SICSLOWPAN_ADDR_CONTEXT_HASH && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+static uint8_t
+context_hash(const uint8_t *prefix)
+{
+  uint8_t h;
+
+  h = prefix[0] ^ prefix[1] ^ prefix[2] ^ prefix[3] ^
+    prefix[4] ^ prefix[5] ^ prefix[6] ^ prefix[7];
+  return (h ^ (h >> 5)) & (CONTEXT_INDEX_SIZE - 1);
+}
+/*--------------------------------------------------------------------*/
+/** \brief rebuild the prefix index after a change of the contexts */
+static void
+context_index_rebuild(void)
+{
+  int i;
+  uint8_t h;
+
+  memset(context_index, 0, sizeof(context_index));
+  for(i = 0; i < SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS; i++) {
+    if(addr_contexts[i].used == 1) {
+      h = context_hash(addr_contexts[i].prefix);
+      while(context_index[h] != 0) {
+        h = (h + 1) & (CONTEXT_INDEX_SIZE - 1);
+      }
+      context_index[h] = i + 1;
+    }
+  }
+}
+/*--------------------------------------------------------------------*/
+#endif /* SICSLOWPAN_ADDR_CONTEXT_HASH && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
 /** \brief find the context corresponding to prefix ipaddr */
 static struct sicslowpan_addr_context*
 addr_context_lookup_by_prefix(uip_ipaddr_t *ipaddr)
 {
 /* Remove code to avoid warnings and save flash if no context is used */
 #if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+#if SICSLOWPAN_ADDR_CONTEXT_HASH
+  uint8_t h;
+  struct sicslowpan_addr_context *c;
+
+  for(h = context_hash(ipaddr->u8); context_index[h] != 0;
+      h = (h + 1) & (CONTEXT_INDEX_SIZE - 1)) {
+    c = &addr_contexts[context_index[h] - 1];
+    if(uip_ipaddr_prefixcmp(&c->prefix, ipaddr, 64)) {
+      return c;
+    }
+  }
+#else /* SICSLOWPAN_ADDR_CONTEXT_HASH */
   int i;
   for(i = 0; i < SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS; i++) {
     if((addr_contexts[i].used == 1) &&
@@ -549,6 +672,7 @@ addr_context_lookup_by_prefix(uip_ipaddr_t *ipaddr)
       return &addr_contexts[i];
     }
   }
+#endif /* SICSLOWPAN_ADDR_CONTEXT_HASH */
 #endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
   return NULL;
 }
@@ -559,12 +683,9 @@ addr_context_lookup_by_number(uint8_t number)
 {
 /* Remove code to avoid warnings and save flash if no context is used */
 #if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
-  int i;
-  for(i = 0; i < SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS; i++) {
-    if((addr_contexts[i].used == 1) &&
-       addr_contexts[i].number == number) {
-      return &addr_contexts[i];
-    }
+  if(number < SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS &&
+     addr_contexts[number].used == 1) {
+    return &addr_contexts[number];
   }
 #endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
   return NULL;
@@ -630,6 +751,77 @@ uncompress_addr(uip_ipaddr_t *ipaddr, uint8_t const prefix[],
   PRINTF("\n");
 }
 
+#if SICSLOWPAN_IPHC_CACHE
+/*--------------------------------------------------------------------*/
+/** \brief the cache entry for the flow of the packet in uip_buf */
+static struct iphc_cache_entry *
+iphc_cache_entry(void)
+{
+  uint8_t h;
+
+  h = UIP_IP_BUF->srcipaddr.u8[15] ^ UIP_IP_BUF->destipaddr.u8[15] ^
+    UIP_IP_BUF->proto;
+  if(UIP_IP_BUF->proto == UIP_PROTO_UDP) {
+    h ^= ((uint8_t *)&UIP_UDP_BUF->srcport)[1] ^
+      ((uint8_t *)&UIP_UDP_BUF->destport)[1];
+  }
+  return &iphc_cache[h % SICSLOWPAN_IPHC_CACHE];
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Reuse the compressed header of the flow, if cached
+ * \return 1 if the header was written to packetbuf, 0 otherwise
+ */
+static int
+iphc_cache_compress(struct iphc_cache_entry *e, linkaddr_t *link_destaddr)
+{
+  if(e->hdr_len == 0 ||
+     memcmp(e->ip, UIP_IP_BUF, 4) != 0 ||
+     memcmp(&e->ip[6], &((uint8_t *)UIP_IP_BUF)[6], UIP_IPH_LEN - 6) != 0 ||
+     !linkaddr_cmp(&e->link_dest, link_destaddr)) {
+    return 0;
+  }
+  if(e->uncomp_hdr_len > UIP_IPH_LEN &&
+     memcmp(e->ports, &UIP_UDP_BUF->srcport, 4) != 0) {
+    return 0;
+  }
+
+  memcpy(packetbuf_ptr, e->hdr, e->hdr_len);
+  packetbuf_hdr_len = e->hdr_len;
+  uncomp_hdr_len = e->uncomp_hdr_len;
+  if(uncomp_hdr_len > UIP_IPH_LEN) {
+    /* LOWPAN_UDP always carries the checksum inline */
+    memcpy(packetbuf_ptr + packetbuf_hdr_len, &UIP_UDP_BUF->udpchksum, 2);
+    packetbuf_hdr_len += 2;
+  }
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+/** \brief keep the header just compressed for the next packets */
+static void
+iphc_cache_store(struct iphc_cache_entry *e, linkaddr_t *link_destaddr)
+{
+  memcpy(e->ip, UIP_IP_BUF, UIP_IPH_LEN);
+  memcpy(e->ports, &UIP_UDP_BUF->srcport, 4);
+  linkaddr_copy(&e->link_dest, link_destaddr);
+  e->uncomp_hdr_len = uncomp_hdr_len;
+  e->hdr_len = packetbuf_hdr_len;
+  if(uncomp_hdr_len > UIP_IPH_LEN) {
+    e->hdr_len -= 2;
+  }
+  memcpy(e->hdr, packetbuf_ptr, e->hdr_len);
+}
+/*--------------------------------------------------------------------*/
+static void
+iphc_cache_flush(void)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_IPHC_CACHE; i++) {
+    iphc_cache[i].hdr_len = 0;
+  }
+}
+#endif /* SICSLOWPAN_IPHC_CACHE */
 /*--------------------------------------------------------------------*/
 /**
  * \brief Compress IP/UDP header
@@ -669,6 +861,10 @@ static void
 compress_hdr_iphc(linkaddr_t *link_destaddr)
 {
   uint8_t tmp, iphc0, iphc1;
+  struct sicslowpan_addr_context *src_context, *dest_context;
+#if SICSLOWPAN_IPHC_CACHE
+  struct iphc_cache_entry *e;
+#endif /* SICSLOWPAN_IPHC_CACHE */
 #if DEBUG
   { uint16_t ndx;
     PRINTF("before compression (%d): ", UIP_IP_BUF->len[1]);
@@ -680,6 +876,14 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
   }
 #endif
 
+#if SICSLOWPAN_IPHC_CACHE
+  e = iphc_cache_entry();
+  if(iphc_cache_compress(e, link_destaddr)) {
+    PRINTF("IPHC: reusing cached header\n");
+    return;
+  }
+#endif /* SICSLOWPAN_IPHC_CACHE */
+
   hc06_ptr = packetbuf_ptr + 2;
   /*
    * As we copy some bit-length fields, in the IPHC encoding bytes,
@@ -700,10 +904,9 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
 
 
   /* check if dest context exists (for allocating third byte) */
-  /* TODO: fix this so that it remembers the looked up values for
-     avoiding two lookups - or set the lookup values immediately */
-  if(addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr) != NULL ||
-     addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr) != NULL) {
+  src_context = addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr);
+  dest_context = addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr);
+  if(dest_context != NULL || src_context != NULL) {
     /* set context flag and increase hc06_ptr */
     PRINTF("IPHC: compressing dest or src ipaddr - setting CID\n");
     iphc1 |= SICSLOWPAN_IPHC_CID;
@@ -796,8 +999,7 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
     PRINTF("IPHC: compressing unspecified - setting SAC\n");
     iphc1 |= SICSLOWPAN_IPHC_SAC;
     iphc1 |= SICSLOWPAN_IPHC_SAM_00;
-  } else if((context = addr_context_lookup_by_prefix(&UIP_IP_BUF->srcipaddr))
-     != NULL) {
+  } else if((context = src_context) != NULL) {
     /* elide the prefix - indicate by CID and set context + SAC */
     PRINTF("IPHC: compressing src with context - setting CID & SAC ctx: %d\n",
            context->number);
@@ -850,7 +1052,7 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
     }
   } else {
     /* Address is unicast, try to compress */
-    if((context = addr_context_lookup_by_prefix(&UIP_IP_BUF->destipaddr)) != NULL) {
+    if((context = dest_context) != NULL) {
       /* elide the prefix */
       iphc1 |= SICSLOWPAN_IPHC_DAC;
       PACKETBUF_IPHC_BUF[2] |= context->number;
@@ -932,6 +1134,9 @@ compress_hdr_iphc(linkaddr_t *link_destaddr)
   PACKETBUF_IPHC_BUF[1] = iphc1;
 
   packetbuf_hdr_len = hc06_ptr - packetbuf_ptr;
+#if SICSLOWPAN_IPHC_CACHE
+  iphc_cache_store(e, link_destaddr);
+#endif /* SICSLOWPAN_IPHC_CACHE */
   return;
 }
 
@@ -1294,6 +1499,16 @@ output(const uip_lladdr_t *localdest)
     set_packet_attrs();
   }
 
+#if TSCH_QUEUE_CLASSES > 1
+  /* RPL control messages go in the highest TSCH traffic class, like
+     keepalives, so that data packets do not hold back the routing
+     topology */
+  if(UIP_IP_BUF->proto == UIP_PROTO_ICMP6 &&
+     UIP_ICMP_BUF->type == ICMP6_RPL) {
+    packetbuf_set_attr(PACKETBUF_ATTR_TSCH_CLASS, TSCH_QUEUE_CLASSES - 1);
+  }
+#endif /* TSCH_QUEUE_CLASSES > 1 */
+
 #if PACKETBUF_WITH_PACKET_TYPE
 #define TCP_FIN 0x01
 #define TCP_ACK 0x10
@@ -1413,6 +1628,8 @@ output(const uip_lladdr_t *localdest)
     queuebuf_to_packetbuf(q);
     queuebuf_free(q);
     q = NULL;
+    /* The packetbuf may have moved to another pool buffer */
+    packetbuf_ptr = packetbuf_dataptr();
 
     /* Check tx result. */
     if((last_tx_status == MAC_TX_COLLISION) ||
@@ -1459,6 +1676,7 @@ output(const uip_lladdr_t *localdest)
       queuebuf_to_packetbuf(q);
       queuebuf_free(q);
       q = NULL;
+      packetbuf_ptr = packetbuf_dataptr();
       processed_ip_out_len += packetbuf_payload_len;
 
       /* Check tx result. */
@@ -1487,6 +1705,218 @@ output(const uip_lladdr_t *localdest)
   return 1;
 }
 
+#if SICSLOWPAN_CONF_FRAG && SICSLOWPAN_FRAG_FORWARD
+/*--------------------------------------------------------------------*/
+/** \name Fragment forwarding
+ * @{                                                                 */
+/*--------------------------------------------------------------------*/
+static struct sicslowpan_frag_fwd *
+frag_fwd_lookup(uint16_t tag)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_FRAG_FORWARD; i++) {
+    if(frag_fwd[i].size > 0 && frag_fwd[i].tag == tag &&
+       linkaddr_cmp(&frag_fwd[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+      if(timer_expired(&frag_fwd[i].lifetime)) {
+        frag_fwd[i].size = 0;
+        return NULL;
+      }
+      return &frag_fwd[i];
+    }
+  }
+  return NULL;
+}
+/*--------------------------------------------------------------------*/
+static struct sicslowpan_frag_fwd *
+frag_fwd_alloc(void)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_FRAG_FORWARD; i++) {
+    if(frag_fwd[i].size == 0 || timer_expired(&frag_fwd[i].lifetime)) {
+      return &frag_fwd[i];
+    }
+  }
+  return NULL;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Take the routing decision for a datagram from its first
+ * fragment, uncompressed in uip_buf, the way tcpip_ipv6_output()
+ * would.
+ * \return The link-layer address of the next hop, or NULL if the
+ * datagram has to be reassembled and handed to the IP layer: it is
+ * for us, it carries extension headers that the IP layer processes
+ * when forwarding, its hop limit expires or the next hop is unknown.
+ */
+static const uip_lladdr_t *
+frag_fwd_nexthop(void)
+{
+  uip_ipaddr_t *nexthop;
+  uip_ds6_route_t *route;
+  uip_ds6_nbr_t *nbr;
+
+  if(uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr) ||
+     uip_ds6_is_my_maddr(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_mcast(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->srcipaddr) ||
+     uip_is_addr_unspecified(&UIP_IP_BUF->srcipaddr) ||
+     uip_is_addr_loopback(&UIP_IP_BUF->destipaddr)) {
+    return NULL;
+  }
+  if(UIP_IP_BUF->proto == UIP_PROTO_HBHO ||
+     UIP_IP_BUF->proto == UIP_PROTO_ROUTING ||
+     UIP_IP_BUF->ttl <= 1) {
+    return NULL;
+  }
+
+  if(uip_ds6_is_addr_onlink(&UIP_IP_BUF->destipaddr)) {
+    nexthop = &UIP_IP_BUF->destipaddr;
+  } else {
+    route = uip_ds6_route_lookup(&UIP_IP_BUF->destipaddr);
+    if(route != NULL) {
+      nexthop = uip_ds6_route_nexthop(route);
+    } else {
+      nexthop = uip_ds6_defrt_choose();
+    }
+  }
+  if(nexthop == NULL) {
+    return NULL;
+  }
+
+  nbr = uip_ds6_nbr_lookup(nexthop);
+  if(nbr == NULL || nbr->state == NBR_INCOMPLETE) {
+    return NULL;
+  }
+  return uip_ds6_nbr_get_ll(nbr);
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Forward the first fragment of a datagram, uncompressed in
+ * uip_buf, and remember where the following fragments go.
+ * \param nexthop The link-layer address of the next hop
+ * \param tag The tag of the incoming fragments
+ * \param frag_size The total length of the datagram
+ * \param first_frag_len The length of the datagram in the first fragment
+ * \return 1 if the fragment was sent, 0 if the datagram has to be
+ * reassembled instead
+ *
+ * The IP header is compressed again for the next hop. The offsets of
+ * the following fragments refer to the uncompressed datagram, so they
+ * remain valid however the header compresses.
+ */
+static int
+frag_fwd_first(const uip_lladdr_t *nexthop, uint16_t tag,
+               uint16_t frag_size, uint16_t first_frag_len)
+{
+  struct sicslowpan_frag_fwd *f;
+  linkaddr_t sender;
+  linkaddr_t dest;
+  int framer_hdrlen;
+  int payload_len;
+
+  f = frag_fwd_alloc();
+  if(f == NULL) {
+    PRINTFI("sicslowpan input: no room to forward tag %d\n", tag);
+    return 0;
+  }
+
+  linkaddr_copy(&sender, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  linkaddr_copy(&dest, (const linkaddr_t *)nexthop);
+
+  UIP_IP_BUF->ttl = UIP_IP_BUF->ttl - 1;
+
+  uncomp_hdr_len = 0;
+  packetbuf_hdr_len = 0;
+  packetbuf_clear();
+  packetbuf_ptr = packetbuf_dataptr();
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_HC06
+  compress_hdr_iphc(&dest);
+#else /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_HC06 */
+  compress_hdr_ipv6(&dest);
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_HC06 */
+  payload_len = first_frag_len - uncomp_hdr_len;
+
+#ifndef SICSLOWPAN_USE_FIXED_HDRLEN
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &dest);
+  framer_hdrlen = NETSTACK_FRAMER.length();
+  if(framer_hdrlen < 0) {
+    framer_hdrlen = SICSLOWPAN_FIXED_HDRLEN;
+  }
+#else /* SICSLOWPAN_USE_FIXED_HDRLEN */
+  framer_hdrlen = SICSLOWPAN_FIXED_HDRLEN;
+#endif /* SICSLOWPAN_USE_FIXED_HDRLEN */
+
+  if(payload_len < 0 ||
+     SICSLOWPAN_FRAG1_HDR_LEN + packetbuf_hdr_len + payload_len >
+     MAC_MAX_PAYLOAD - framer_hdrlen) {
+    /* The header compresses worse towards the next hop */
+    PRINTFI("sicslowpan input: first fragment too large to forward\n");
+    return 0;
+  }
+
+  memmove(packetbuf_ptr + SICSLOWPAN_FRAG1_HDR_LEN, packetbuf_ptr,
+          packetbuf_hdr_len);
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+        ((SICSLOWPAN_DISPATCH_FRAG1 << 8) | frag_size));
+  f->out_tag = my_tag++;
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, f->out_tag);
+  packetbuf_hdr_len += SICSLOWPAN_FRAG1_HDR_LEN;
+  memcpy(packetbuf_ptr + packetbuf_hdr_len,
+         (uint8_t *)UIP_IP_BUF + uncomp_hdr_len, payload_len);
+  packetbuf_set_datalen(packetbuf_hdr_len + payload_len);
+
+  linkaddr_copy(&f->sender, &sender);
+  f->tag = tag;
+  linkaddr_copy(&f->nexthop, &dest);
+  f->size = frag_size;
+  f->forwarded_len = first_frag_len;
+  timer_set(&f->lifetime, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+
+  PRINTFI("sicslowpan input: forwarding tag %d as tag %d\n", tag, f->out_tag);
+  UIP_STAT(++uip_stat.ip.forwarded);
+  sicslowpan_frag_stats.forwarded++;
+  send_packet(&dest);
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Forward a subsequent fragment, still in packetbuf, if its
+ * datagram is being forwarded.
+ * \param tag The tag of the incoming fragment
+ * \return 1 if the fragment was forwarded, 0 otherwise
+ */
+static int
+frag_fwd_next(uint16_t tag)
+{
+  struct sicslowpan_frag_fwd *f;
+
+  f = frag_fwd_lookup(tag);
+  if(f == NULL || packetbuf_datalen() <= SICSLOWPAN_FRAGN_HDR_LEN) {
+    return 0;
+  }
+
+  f->forwarded_len += packetbuf_datalen() - SICSLOWPAN_FRAGN_HDR_LEN;
+  if(f->forwarded_len >= f->size) {
+    /* This was the last fragment of the datagram */
+    f->size = 0;
+  }
+
+  /* Only the tag changes, the fragment is sent as it came */
+  packetbuf_compact();
+  packetbuf_attr_clear();
+  packetbuf_ptr = packetbuf_dataptr();
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, f->out_tag);
+
+  sicslowpan_frag_stats.forwarded++;
+  send_packet(&f->nexthop);
+  return 1;
+}
+/** @} */
+#endif /* SICSLOWPAN_CONF_FRAG && SICSLOWPAN_FRAG_FORWARD */
+
 /*--------------------------------------------------------------------*/
 /** \brief Process a received 6lowpan packet.
  *
@@ -1559,6 +1989,9 @@ input(void)
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
 
       if(frag_context == -1) {
+#if SICSLOWPAN_FRAG_FORWARD
+        sicslowpan_frag_stats.dropped++;
+#endif /* SICSLOWPAN_FRAG_FORWARD */
         return;
       }
 
@@ -1583,13 +2016,25 @@ input(void)
       PRINTFI("last_fragment?: packetbuf_payload_len %d frag_size %d\n",
               packetbuf_datalen() - packetbuf_hdr_len, frag_size);
 
+#if SICSLOWPAN_FRAG_FORWARD
+      if(frag_fwd_next(frag_tag)) {
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARD */
+
       /* Add the fragment to the fragmentation context (this will also
          copy the payload) */
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
 
       if(frag_context == -1) {
+#if SICSLOWPAN_FRAG_FORWARD
+        sicslowpan_frag_stats.dropped++;
+#endif /* SICSLOWPAN_FRAG_FORWARD */
         return;
       }
+#if SICSLOWPAN_FRAG_FORWARD
+      sicslowpan_frag_stats.reassembled++;
+#endif /* SICSLOWPAN_FRAG_FORWARD */
 
       /* Ok - add_fragment will store the fragment automatically - so
          we should not store more */
@@ -1680,6 +2125,24 @@ input(void)
     if(first_fragment != 0) {
       frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
       frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+#if SICSLOWPAN_FRAG_FORWARD
+      {
+        const uip_lladdr_t *nexthop;
+
+        /* Datagrams that are not for us are forwarded fragment by
+           fragment if we have a route for them */
+        memcpy((uint8_t *)UIP_IP_BUF, frag_info[frag_context].first_frag,
+               frag_info[frag_context].first_frag_len);
+        nexthop = frag_fwd_nexthop();
+        if(nexthop != NULL &&
+           frag_fwd_first(nexthop, frag_tag, frag_size,
+                          frag_info[frag_context].first_frag_len)) {
+          clear_fragments(frag_context);
+          return;
+        }
+        sicslowpan_frag_stats.reassembled++;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARD */
     }
     /* For the last fragment, we are OK if there is extrenous bytes at
        the end of the packet. */
@@ -1787,9 +2250,46 @@ sicslowpan_init(void)
   }
 #endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 1 */
 
+#if SICSLOWPAN_ADDR_CONTEXT_HASH && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+  context_index_rebuild();
+#endif /* SICSLOWPAN_ADDR_CONTEXT_HASH && SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+#if SICSLOWPAN_IPHC_CACHE
+  iphc_cache_flush();
+#endif /* SICSLOWPAN_IPHC_CACHE */
+
 #endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_HC06 */
 }
 /*--------------------------------------------------------------------*/
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_HC06
+int
+sicslowpan_set_addr_context(uint8_t number, const uint8_t *prefix)
+{
+#if SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0
+  if(number >= SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS) {
+    return 0;
+  }
+  if(prefix == NULL) {
+    addr_contexts[number].used = 0;
+  } else {
+    addr_contexts[number].used = 1;
+    addr_contexts[number].number = number;
+    memcpy(addr_contexts[number].prefix, prefix,
+           sizeof(addr_contexts[number].prefix));
+  }
+#if SICSLOWPAN_ADDR_CONTEXT_HASH
+  context_index_rebuild();
+#endif /* SICSLOWPAN_ADDR_CONTEXT_HASH */
+#if SICSLOWPAN_IPHC_CACHE
+  /* Cached headers may have been compressed with the old context */
+  iphc_cache_flush();
+#endif /* SICSLOWPAN_IPHC_CACHE */
+  return 1;
+#else /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+  return 0;
+#endif /* SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS > 0 */
+}
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_HC06 */
+/*--------------------------------------------------------------------*/
 int
 sicslowpan_get_last_rssi(void)
 {
@@ -319,6 +319,39 @@ struct sicslowpan_nh_compressor {
 
 };
 
+/* Forward fragments of datagrams that are not for us as they arrive,
+   following the routing decision taken on the first fragment,
+   instead of reassembling the whole datagram first. The value is the
+   number of datagrams that can be forwarded at the same time. */
+#ifdef SICSLOWPAN_CONF_FRAG_FORWARD
+#define SICSLOWPAN_FRAG_FORWARD SICSLOWPAN_CONF_FRAG_FORWARD
+#else /* SICSLOWPAN_CONF_FRAG_FORWARD */
+#define SICSLOWPAN_FRAG_FORWARD 0
+#endif /* SICSLOWPAN_CONF_FRAG_FORWARD */
+
+#if SICSLOWPAN_FRAG_FORWARD
+/** \brief Fragment statistics of the fragment forwarding mode */
+struct sicslowpan_frag_stats {
+  /** Fragments forwarded without reassembly */
+  uint16_t forwarded;
+  /** Fragments stored for reassembly */
+  uint16_t reassembled;
+  /** Fragments dropped for lack of a reassembly context or buffer */
+  uint16_t dropped;
+};
+
+extern struct sicslowpan_frag_stats sicslowpan_frag_stats;
+#endif /* SICSLOWPAN_FRAG_FORWARD */
+
+/**
+ * \brief Set or remove an IPHC address context
+ * \param number The number of the context, from 0 to 15
+ * \param prefix The 64-bit prefix of the context, or NULL to remove it
+ * \return 1 on success, 0 if the number is beyond
+ * SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS
+ */
+int sicslowpan_set_addr_context(uint8_t number, const uint8_t *prefix);
+
 int sicslowpan_get_last_rssi(void);
 
 extern const struct network_driver sicslowpan_driver;
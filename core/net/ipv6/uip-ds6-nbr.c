@@ -47,6 +47,7 @@
 #include <stdlib.h>
 #include <stddef.h>
 #include "lib/list.h"
+#include "lib/hashindex.h"
 #include "net/link-stats.h"
 #include "net/linkaddr.h"
 #include "net/packetbuf.h"
@@ -71,6 +72,26 @@ void LINK_NEIGHBOR_CALLBACK(const linkaddr_t *addr, int status, int numtx);
 
 NBR_TABLE_GLOBAL(uip_ds6_nbr_t, ds6_neighbors);
 
+#if UIP_DS6_NBR_HASH
+struct uip_ds6_nbr_stats uip_ds6_nbr_stats;
+
+#define NBR_FROM_INDEX(i) (&((uip_ds6_nbr_t *)ds6_neighbors->data)[i])
+#define INDEX_FROM_NBR(n) ((n) - (uip_ds6_nbr_t *)ds6_neighbors->data)
+
+/*---------------------------------------------------------------------------*/
+/* Get the IPv6 address of a neighbor index */
+static const void *
+ipaddr_from_index(uint16_t index)
+{
+  return &NBR_FROM_INDEX(index)->ipaddr;
+}
+/* Hash index over the IPv6 addresses of the neighbors in use */
+HASHINDEX(ipaddr_index, NBR_TABLE_MAX_NEIGHBORS, sizeof(uip_ipaddr_t),
+          ipaddr_from_index);
+#define hash_insert(nbr) hashindex_add(&ipaddr_index, INDEX_FROM_NBR(nbr))
+#define hash_remove(nbr) hashindex_remove(&ipaddr_index, INDEX_FROM_NBR(nbr))
+#endif /* UIP_DS6_NBR_HASH */
+/*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 void
 uip_ds6_neighbors_init(void)
@@ -84,10 +105,24 @@ uip_ds6_nbr_add(const uip_ipaddr_t *ipaddr, const uip_lladdr_t *lladdr,
                 uint8_t isrouter, uint8_t state, nbr_table_reason_t reason,
                 void *data)
 {
-  uip_ds6_nbr_t *nbr = nbr_table_add_lladdr(ds6_neighbors, (linkaddr_t*)lladdr
-                                            , reason, data);
+  uip_ds6_nbr_t *nbr;
+
+#if UIP_DS6_NBR_HASH
+  /* Adding an existing neighbor clears its entry, so take the old
+     address out of the index first */
+  nbr = nbr_table_get_from_lladdr(ds6_neighbors, (linkaddr_t *)lladdr);
+  if(nbr != NULL) {
+    hash_remove(nbr);
+  }
+#endif /* UIP_DS6_NBR_HASH */
+
+  nbr = nbr_table_add_lladdr(ds6_neighbors, (linkaddr_t*)lladdr
+                             , reason, data);
   if(nbr) {
     uip_ipaddr_copy(&nbr->ipaddr, ipaddr);
+#if UIP_DS6_NBR_HASH
+    hash_insert(nbr);
+#endif /* UIP_DS6_NBR_HASH */
 #if UIP_ND6_SEND_RA || !UIP_CONF_ROUTER
     nbr->isrouter = isrouter;
 #endif /* UIP_ND6_SEND_RA || !UIP_CONF_ROUTER */
@@ -131,6 +166,9 @@ uip_ds6_nbr_rm(uip_ds6_nbr_t *nbr)
     uip_packetqueue_free(&nbr->packethandle);
 #endif /* UIP_CONF_IPV6_QUEUE_PKT */
     NEIGHBOR_STATE_CHANGED(nbr);
+#if UIP_DS6_NBR_HASH
+    hash_remove(nbr);
+#endif /* UIP_DS6_NBR_HASH */
     return nbr_table_remove(ds6_neighbors, nbr);
   }
   return 0;
@@ -168,6 +206,19 @@ uip_ds6_nbr_num(void)
 uip_ds6_nbr_t *
 uip_ds6_nbr_lookup(const uip_ipaddr_t *ipaddr)
 {
+#if UIP_DS6_NBR_HASH
+  int index;
+
+  if(ipaddr != NULL) {
+    index = hashindex_lookup(&ipaddr_index, ipaddr);
+    if(index >= 0) {
+      uip_ds6_nbr_stats.hits++;
+      return NBR_FROM_INDEX(index);
+    }
+  }
+  uip_ds6_nbr_stats.misses++;
+  return NULL;
+#else /* UIP_DS6_NBR_HASH */
   uip_ds6_nbr_t *nbr = nbr_table_head(ds6_neighbors);
   if(ipaddr != NULL) {
     while(nbr != NULL) {
@@ -178,6 +229,7 @@ uip_ds6_nbr_lookup(const uip_ipaddr_t *ipaddr)
     }
   }
   return NULL;
+#endif /* UIP_DS6_NBR_HASH */
 }
 /*---------------------------------------------------------------------------*/
 uip_ds6_nbr_t *
@@ -62,6 +62,14 @@
 #define  NBR_DELAY 3
 #define  NBR_PROBE 4
 
+/* Look neighbors up by IPv6 address through an open-addressed hash
+   index instead of walking the neighbor table. */
+#ifdef UIP_DS6_NBR_CONF_HASH
+#define UIP_DS6_NBR_HASH UIP_DS6_NBR_CONF_HASH
+#else /* UIP_DS6_NBR_CONF_HASH */
+#define UIP_DS6_NBR_HASH 0
+#endif /* UIP_DS6_NBR_CONF_HASH */
+
 NBR_TABLE_DECLARE(ds6_neighbors);
 
 /** \brief An entry in the nbr cache */
@@ -82,6 +90,16 @@ typedef struct uip_ds6_nbr {
 
 void uip_ds6_neighbors_init(void);
 
+#if UIP_DS6_NBR_HASH
+/** \brief Outcome of uip_ds6_nbr_lookup() calls, when the hash index
+    is in use */
+struct uip_ds6_nbr_stats {
+  uint32_t hits;   /**< Lookups that found a neighbor */
+  uint32_t misses; /**< Lookups that found no neighbor */
+};
+extern struct uip_ds6_nbr_stats uip_ds6_nbr_stats;
+#endif /* UIP_DS6_NBR_HASH */
+
 /** \brief Neighbor Cache basic routines */
 uip_ds6_nbr_t *uip_ds6_nbr_add(const uip_ipaddr_t *ipaddr,
                                const uip_lladdr_t *lladdr,
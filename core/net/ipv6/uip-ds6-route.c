@@ -75,6 +75,24 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_TRIE
+/* The routes are also indexed by a path-compressed binary trie over
+   their prefixes. A node that carries a route matches its route
+   prefix; the other nodes only branch on the first bit after their
+   own prefix. Each route adds at most one node of each kind. */
+struct trie_node {
+  struct trie_node *child[2];
+  uip_ds6_route_t *route;
+  uip_ipaddr_t key;
+  uint8_t length;
+};
+MEMB(trienodememb, struct trie_node, 2 * UIP_DS6_ROUTE_NB);
+static struct trie_node *trie_root;
+#if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+static uint32_t num_lookups;
+#endif /* UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
+#endif /* UIP_DS6_ROUTE_TRIE */
+
 #endif /* (UIP_CONF_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -119,6 +137,171 @@ assert_nbr_routes_list_sane(void)
 }
 #endif /* DEBUG != DEBUG_NONE */
 /*---------------------------------------------------------------------------*/
+#if (UIP_CONF_MAX_ROUTES != 0) && UIP_DS6_ROUTE_TRIE
+/* Get bit number i of an address, counting from the most significant */
+#define TRIE_BIT(addr, i) (((addr)->u8[(i) >> 3] >> (7 - ((i) & 7))) & 1)
+
+/* Get the number of leading bits, at most max, that two addresses
+   have in common, given that they have the first from bits in common */
+static uint8_t
+trie_common(const uip_ipaddr_t *a, const uip_ipaddr_t *b,
+            uint8_t from, uint8_t max)
+{
+  uint8_t i, x;
+
+  for(i = from & ~7; i < max; i += 8) {
+    x = a->u8[i >> 3] ^ b->u8[i >> 3];
+    if(x != 0) {
+      while(!(x & 0x80)) {
+        x <<= 1;
+        i++;
+      }
+      return i < max ? i : max;
+    }
+  }
+  return max;
+}
+/*---------------------------------------------------------------------------*/
+static struct trie_node *
+trie_node_alloc(const uip_ipaddr_t *key, uint8_t length,
+                uip_ds6_route_t *route)
+{
+  struct trie_node *n = memb_alloc(&trienodememb);
+
+  if(n != NULL) {
+    n->child[0] = n->child[1] = NULL;
+    n->route = route;
+    uip_ipaddr_copy(&n->key, key);
+    n->length = length;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+/* Get the node of a prefix, or NULL if the trie has none */
+static struct trie_node *
+trie_find(const uip_ipaddr_t *key, uint8_t length)
+{
+  struct trie_node *n = trie_root;
+
+  while(n != NULL && n->length < length &&
+        trie_common(key, &n->key, 0, n->length) == n->length) {
+    n = n->child[TRIE_BIT(key, n->length)];
+  }
+  if(n != NULL && n->length == length &&
+     trie_common(key, &n->key, 0, length) == length) {
+    return n;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static int
+trie_insert(uip_ds6_route_t *route)
+{
+  struct trie_node **link, *n, *branch, *leaf;
+  const uip_ipaddr_t *key = &route->ipaddr;
+  uint8_t length = route->length;
+  uint8_t common;
+
+  for(link = &trie_root; (n = *link) != NULL;
+      link = &n->child[TRIE_BIT(key, n->length)]) {
+    common = trie_common(key, &n->key, 0,
+                         length < n->length ? length : n->length);
+    if(common == length && length == n->length) {
+      /* The prefix already has a node */
+      n->route = route;
+      return 1;
+    }
+    if(common == length) {
+      /* The new prefix covers the node */
+      leaf = trie_node_alloc(key, length, route);
+      if(leaf == NULL) {
+        return 0;
+      }
+      leaf->child[TRIE_BIT(&n->key, length)] = n;
+      *link = leaf;
+      return 1;
+    }
+    if(common < n->length) {
+      /* The prefixes part after common bits */
+      branch = trie_node_alloc(key, common, NULL);
+      leaf = trie_node_alloc(key, length, route);
+      if(branch == NULL || leaf == NULL) {
+        if(branch != NULL) {
+          memb_free(&trienodememb, branch);
+        }
+        if(leaf != NULL) {
+          memb_free(&trienodememb, leaf);
+        }
+        return 0;
+      }
+      branch->child[TRIE_BIT(key, common)] = leaf;
+      branch->child[TRIE_BIT(&n->key, common)] = n;
+      *link = branch;
+      return 1;
+    }
+  }
+  *link = trie_node_alloc(key, length, route);
+  return *link != NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+trie_remove(uip_ds6_route_t *route)
+{
+  struct trie_node **link, **parent_link, *n, *parent;
+
+  parent_link = NULL;
+  link = &trie_root;
+  while((n = *link) != NULL && n->length < route->length) {
+    parent_link = link;
+    link = &n->child[TRIE_BIT(&route->ipaddr, n->length)];
+  }
+  if(n == NULL || n->route != route) {
+    return;
+  }
+
+  n->route = NULL;
+  if(n->child[0] != NULL && n->child[1] != NULL) {
+    /* The node still branches */
+    return;
+  }
+  *link = n->child[0] != NULL ? n->child[0] : n->child[1];
+  memb_free(&trienodememb, n);
+
+  /* A branching parent left with a single child is not needed */
+  if(*link == NULL && parent_link != NULL) {
+    parent = *parent_link;
+    if(parent->route == NULL) {
+      *parent_link = parent->child[0] != NULL ?
+        parent->child[0] : parent->child[1];
+      memb_free(&trienodememb, parent);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+trie_lookup(const uip_ipaddr_t *addr)
+{
+  struct trie_node *n;
+  uip_ds6_route_t *found = NULL;
+  uint8_t matched = 0;
+
+  /* Each node shares the prefix of its parent, so only the bits after
+     that need to be compared */
+  for(n = trie_root; n != NULL &&
+        trie_common(addr, &n->key, matched, n->length) == n->length;
+      n = n->child[TRIE_BIT(addr, n->length)]) {
+    if(n->route != NULL) {
+      found = n->route;
+    }
+    if(n->length == 128) {
+      break;
+    }
+    matched = n->length;
+  }
+  return found;
+}
+#endif /* (UIP_CONF_MAX_ROUTES != 0) && UIP_DS6_ROUTE_TRIE */
+/*---------------------------------------------------------------------------*/
 #if UIP_DS6_NOTIFICATIONS
 static void
 call_route_callback(int event, uip_ipaddr_t *route,
@@ -164,6 +347,10 @@ uip_ds6_route_init(void)
   list_init(routelist);
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
+#if UIP_DS6_ROUTE_TRIE
+  memb_init(&trienodememb);
+  trie_root = NULL;
+#endif /* UIP_DS6_ROUTE_TRIE */
 #endif /* (UIP_CONF_MAX_ROUTES != 0) */
 
   memb_init(&defaultroutermemb);
@@ -254,15 +441,20 @@ uip_ds6_route_t *
 uip_ds6_route_lookup(uip_ipaddr_t *addr)
 {
 #if (UIP_CONF_MAX_ROUTES != 0)
+#if !UIP_DS6_ROUTE_TRIE
   uip_ds6_route_t *r;
-  uip_ds6_route_t *found_route;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_TRIE */
+  uip_ds6_route_t *found_route;
 
   PRINTF("uip-ds6-route: Looking up route for ");
   PRINT6ADDR(addr);
   PRINTF("\n");
 
 
+#if UIP_DS6_ROUTE_TRIE
+  found_route = trie_lookup(addr);
+#else /* UIP_DS6_ROUTE_TRIE */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -278,6 +470,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_TRIE */
 
   if(found_route != NULL) {
     PRINTF("uip-ds6-route: Found route: ");
@@ -289,6 +482,16 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     PRINTF("uip-ds6-route: No route found\n");
   }
 
+#if UIP_DS6_ROUTE_TRIE
+  /* The trie makes the order of the route list irrelevant to lookups,
+     so it only needs to track use for dropping the least recently
+     used route */
+#if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  if(found_route != NULL) {
+    found_route->last_used = ++num_lookups;
+  }
+#endif /* UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
+#else /* UIP_DS6_ROUTE_TRIE */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -298,6 +501,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* UIP_DS6_ROUTE_TRIE */
 
   return found_route;
 #else /* (UIP_CONF_MAX_ROUTES != 0) */
@@ -343,6 +547,16 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
 
     uip_ds6_route_rm(r);
   }
+#if UIP_DS6_ROUTE_TRIE
+  /* The lookup above may have found a longer prefix. The trie holds
+     a single route per prefix, so drop any route for this one. */
+  {
+    struct trie_node *n = trie_find(ipaddr, length);
+    if(n != NULL && n->route != NULL) {
+      uip_ds6_route_rm(n->route);
+    }
+  }
+#endif /* UIP_DS6_ROUTE_TRIE */
   {
     struct uip_ds6_route_neighbor_routes *routes;
     /* If there is no routing entry, create one. We first need to
@@ -353,9 +567,23 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
       uip_ds6_route_t *oldest;
       oldest = NULL;
 #if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+#if UIP_DS6_ROUTE_TRIE
+      /* Removing the route entry that was used the longest ago */
+      {
+        uip_ds6_route_t *route;
+        for(route = list_head(routelist); route != NULL;
+            route = list_item_next(route)) {
+          if(oldest == NULL || num_lookups - route->last_used >
+             num_lookups - oldest->last_used) {
+            oldest = route;
+          }
+        }
+      }
+#else /* UIP_DS6_ROUTE_TRIE */
       /* Removing the oldest route entry from the route table. The
          least recently used route is the first route on the list. */
       oldest = list_tail(routelist);
+#endif /* UIP_DS6_ROUTE_TRIE */
 #endif
       if(oldest == NULL) {
         return NULL;
@@ -437,6 +665,19 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
 
+#if UIP_DS6_ROUTE_TRIE
+#if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  r->last_used = num_lookups;
+#endif /* UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
+  if(!trie_insert(r)) {
+    /* This should not happen, as the trie has room for two nodes
+       per route. */
+    PRINTF("uip_ds6_route_add: could not add route to trie\n");
+    uip_ds6_route_rm(r);
+    return NULL;
+  }
+#endif /* UIP_DS6_ROUTE_TRIE */
+
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
 #endif
@@ -479,6 +720,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_TRIE
+    trie_remove(route);
+#endif /* UIP_DS6_ROUTE_TRIE */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -88,6 +88,15 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_CONF_MAX_ROUTES */
 
+/* Look routes up through a path-compressed binary trie over the route
+   prefixes instead of walking the routing table. Costs up to two trie
+   nodes per route. */
+#ifdef UIP_DS6_ROUTE_CONF_TRIE
+#define UIP_DS6_ROUTE_TRIE UIP_DS6_ROUTE_CONF_TRIE
+#else /* UIP_DS6_ROUTE_CONF_TRIE */
+#define UIP_DS6_ROUTE_TRIE 0
+#endif /* UIP_DS6_ROUTE_CONF_TRIE */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -156,6 +165,11 @@ typedef struct uip_ds6_route {
   uip_ipaddr_t ipaddr;
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   UIP_DS6_ROUTE_STATE_TYPE state;
+#endif
+#if UIP_DS6_ROUTE_TRIE && UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* Lookup count at the last use of the route. The trie does not
+     keep the route list in order of use. */
+  uint32_t last_used;
 #endif
   uint8_t length;
 } uip_ds6_route_t;
@@ -312,7 +312,8 @@ schedule_powercycle(struct rtimer *t, rtimer_clock_t time)
       time = now + RTIMER_GUARD_TIME;
     }
 
-    r = rtimer_set(t, time, 1, powercycle_wrapper, NULL);
+    r = rtimer_set_with_priority(t, time, powercycle_wrapper, NULL,
+                                 RTIMER_PRIORITY_MAC);
 
     if(r != RTIMER_OK) {
       PRINTF("schedule_powercycle: could not set rtimer\n");
@@ -333,7 +334,8 @@ schedule_powercycle_fixed(struct rtimer *t, rtimer_clock_t fixed_time)
       fixed_time = now + RTIMER_GUARD_TIME;
     }
 
-    r = rtimer_set(t, fixed_time, 1, powercycle_wrapper, NULL);
+    r = rtimer_set_with_priority(t, fixed_time, powercycle_wrapper, NULL,
+                                 RTIMER_PRIORITY_MAC);
     if(r != RTIMER_OK) {
       PRINTF("schedule_powercycle: could not set rtimer\n");
     }
@@ -611,7 +613,7 @@ send_packet(mac_callback_t mac_callback, void *mac_callback_ptr,
   }
 
   transmit_len = packetbuf_totlen();
-  NETSTACK_RADIO.prepare(packetbuf_hdrptr(), transmit_len);
+  NETSTACK_RADIO.prepare(packetbuf_const_hdrptr(), transmit_len);
 
   if(!is_broadcast && !is_receiver_awake) {
 #if WITH_PHASE_OPTIMIZATION
@@ -50,6 +50,7 @@
 
 #include "lib/list.h"
 #include "lib/memb.h"
+#include "lib/hashindex.h"
 
 #include <string.h>
 
@@ -124,18 +125,82 @@ struct neighbor_queue {
 #define CSMA_MAX_PACKET_PER_NEIGHBOR MAX_QUEUED_PACKETS
 #endif /* CSMA_CONF_MAX_PACKET_PER_NEIGHBOR */
 
+/* Look neighbor queues up by address through an open-addressed hash
+   index instead of walking the list of queues */
+#ifdef CSMA_CONF_HASH
+#define CSMA_HASH CSMA_CONF_HASH
+#else /* CSMA_CONF_HASH */
+#define CSMA_HASH 0
+#endif /* CSMA_CONF_HASH */
+
+/* Send the packets queued for a neighbor in a burst: all but the last
+   one carry the frame-pending bit so that the receiver keeps its radio
+   on, and once the first one got the channel the others follow it
+   without a backoff of their own */
+#ifdef CSMA_CONF_BURST
+#define CSMA_BURST CSMA_CONF_BURST
+#else /* CSMA_CONF_BURST */
+#define CSMA_BURST 0
+#endif /* CSMA_CONF_BURST */
+
 #define MAX_QUEUED_PACKETS QUEUEBUF_NUM
 MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
 MEMB(packet_memb, struct rdc_buf_list, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
 LIST(neighbor_list);
 
+
+#if CSMA_BURST
+/* The neighbor whose packets the RDC is sending, NULL once its queue
+   has been freed */
+static struct neighbor_queue *burst_nbr;
+#endif /* CSMA_BURST */
+
 static void packet_sent(void *ptr, int status, int num_transmissions);
 static void transmit_packet_list(void *ptr);
+static void schedule_transmission(struct neighbor_queue *n);
+/*---------------------------------------------------------------------------*/
+#if CSMA_HASH
+#define NBR_FROM_INDEX(i) (&((struct neighbor_queue *)neighbor_memb.mem)[i])
+#define INDEX_FROM_NBR(n) ((n) - (struct neighbor_queue *)neighbor_memb.mem)
+
+/* Get the address of a neighbor queue index */
+static const void *
+addr_from_index(uint16_t index)
+{
+  return &NBR_FROM_INDEX(index)->addr;
+}
+/* Hash index over the addresses of the neighbor queues */
+HASHINDEX(addr_index, CSMA_MAX_NEIGHBOR_QUEUES, LINKADDR_SIZE,
+          addr_from_index);
+#define hash_insert(n) hashindex_add(&addr_index, INDEX_FROM_NBR(n))
+#define hash_remove(n) hashindex_remove(&addr_index, INDEX_FROM_NBR(n))
+#else /* CSMA_HASH */
+#define hash_insert(n)
+#define hash_remove(n)
+#endif /* CSMA_HASH */
+/*---------------------------------------------------------------------------*/
+static void
+free_neighbor(struct neighbor_queue *n)
+{
+  hash_remove(n);
+  list_remove(neighbor_list, n);
+  memb_free(&neighbor_memb, n);
+#if CSMA_BURST
+  if(n == burst_nbr) {
+    burst_nbr = NULL;
+  }
+#endif /* CSMA_BURST */
+}
 /*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
+#if CSMA_HASH
+  int index = hashindex_lookup(&addr_index, addr);
+
+  return index >= 0 ? NBR_FROM_INDEX(index) : NULL;
+#else /* CSMA_HASH */
   struct neighbor_queue *n = list_head(neighbor_list);
   while(n != NULL) {
     if(linkaddr_cmp(&n->addr, addr)) {
@@ -144,6 +209,7 @@ neighbor_queue_from_addr(const linkaddr_t *addr)
     n = list_item_next(n);
   }
   return NULL;
+#endif /* CSMA_HASH */
 }
 /*---------------------------------------------------------------------------*/
 static clock_time_t
@@ -173,7 +239,20 @@ transmit_packet_list(void *ptr)
       PRINTF("csma: preparing number %d %p, queue len %d\n", n->transmissions, q,
           list_length(n->queued_packet_list));
       /* Send packets in the neighbor's list */
+#if CSMA_BURST
+      burst_nbr = n;
       NETSTACK_RDC.send_list(packet_sent, n, q);
+      /* The burst stops at a failed packet, which has been rescheduled,
+         or at the end of the list the RDC was given. Packets queued
+         in the meantime still need a transmission. */
+      if(burst_nbr == n && list_head(n->queued_packet_list) != NULL &&
+         ctimer_expired(&n->transmit_timer)) {
+        schedule_transmission(n);
+      }
+      burst_nbr = NULL;
+#else /* CSMA_BURST */
+      NETSTACK_RDC.send_list(packet_sent, n, q);
+#endif /* CSMA_BURST */
     }
   }
 }
@@ -214,13 +293,18 @@ free_packet(struct neighbor_queue *n, struct rdc_buf_list *p, int status)
       /* There is a next packet. We reset current tx information */
       n->transmissions = 0;
       n->collisions = CSMA_MIN_BE;
-      /* Schedule next transmissions */
-      schedule_transmission(n);
+#if CSMA_BURST
+      /* In a burst, the RDC goes on with the next packet */
+      if(n != burst_nbr)
+#endif /* CSMA_BURST */
+      {
+        /* Schedule next transmissions */
+        schedule_transmission(n);
+      }
     } else {
       /* This was the last packet in the queue, we free the neighbor */
       ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
+      free_neighbor(n);
     }
   }
 }
@@ -398,6 +482,7 @@ send_packet(mac_callback_t sent, void *ptr)
       LIST_STRUCT_INIT(n, queued_packet_list);
       /* Add neighbor to the list */
       list_add(neighbor_list, n);
+      hash_insert(n);
     }
   }
 
@@ -411,6 +496,9 @@ send_packet(mac_callback_t sent, void *ptr)
           q->buf = queuebuf_new_from_packetbuf();
           if(q->buf != NULL) {
             struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
+#if CSMA_BURST
+            struct rdc_buf_list *last = list_tail(n->queued_packet_list);
+#endif /* CSMA_BURST */
             /* Neighbor and packet successfully allocated */
             if(packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS) == 0) {
               /* Use default configuration for max transmissions */
@@ -430,6 +518,14 @@ send_packet(mac_callback_t sent, void *ptr)
             {
               list_add(n->queued_packet_list, q);
             }
+#if CSMA_BURST
+            /* Mark the packet that now has another one behind it */
+            if(list_item_next(q) != NULL) {
+              queuebuf_set_attr(q->buf, PACKETBUF_ATTR_PENDING, 1);
+            } else if(last != NULL) {
+              queuebuf_set_attr(last->buf, PACKETBUF_ATTR_PENDING, 1);
+            }
+#endif /* CSMA_BURST */
 
             PRINTF("csma: send_packet, queue length %d, free packets %d\n",
                    list_length(n->queued_packet_list), memb_numfree(&packet_memb));
@@ -447,8 +543,7 @@ send_packet(mac_callback_t sent, void *ptr)
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
       if(list_length(n->queued_packet_list) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
+        free_neighbor(n);
       }
     } else {
       PRINTF("csma: Neighbor queue full\n");
@@ -493,6 +588,9 @@ init(void)
   memb_init(&packet_memb);
   memb_init(&metadata_memb);
   memb_init(&neighbor_memb);
+#if CSMA_HASH
+  hashindex_init(&addr_index);
+#endif /* CSMA_HASH */
 }
 /*---------------------------------------------------------------------------*/
 const struct mac_driver csma_driver = {
@@ -457,7 +457,7 @@ send_packet(void)
    PRINTF("cxmac: send failed, too large header\n");
     return MAC_TX_ERR_FATAL;
   }
-  memcpy(strobe, packetbuf_hdrptr(), len);
+  memcpy(strobe, packetbuf_const_hdrptr(), len);
   strobe[len] = DISPATCH; /* dispatch */
   strobe[len + 1] = TYPE_STROBE; /* type */
 
@@ -596,7 +596,7 @@ send_packet(void)
 #else
 	  /* restore the packet to send */
 	  queuebuf_to_packetbuf(packet);
-	  NETSTACK_RADIO.send(packetbuf_hdrptr(), packetbuf_totlen());
+	  NETSTACK_RADIO.send(packetbuf_const_hdrptr(), packetbuf_totlen());
 #endif
 	  off();
 	} else {
@@ -644,7 +644,7 @@ send_packet(void)
 
   /* Send the data packet. */
   if((is_broadcast || got_strobe_ack || is_streaming) && collisions == 0) {
-    NETSTACK_RADIO.send(packetbuf_hdrptr(), packetbuf_totlen());
+    NETSTACK_RADIO.send(packetbuf_const_hdrptr(), packetbuf_totlen());
   }
 
 #if WITH_ENCOUNTER_OPTIMIZATION
@@ -780,7 +780,7 @@ input_packet(void)
 	  someone_is_sending = 1;
 	  waiting_for_packet = 1;
 	  on();
-	  NETSTACK_RADIO.send(packetbuf_hdrptr(), packetbuf_totlen());
+	  NETSTACK_RADIO.send(packetbuf_const_hdrptr(), packetbuf_totlen());
 	  PRINTDEBUG("cxmac: send strobe ack %u\n", packetbuf_totlen());
 	} else {
 	  PRINTF("cxmac: failed to send strobe ack\n");
@@ -839,7 +839,7 @@ send_announcement(void *ptr)
     packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_null);
     packetbuf_set_attr(PACKETBUF_ATTR_RADIO_TXPOWER, announcement_radio_txpower);
     if(NETSTACK_FRAMER.create() >= 0) {
-      NETSTACK_RADIO.send(packetbuf_hdrptr(), packetbuf_totlen());
+      NETSTACK_RADIO.send(packetbuf_const_hdrptr(), packetbuf_totlen());
     }
   }
 }
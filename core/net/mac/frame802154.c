@@ -487,6 +487,56 @@ frame802154_parse_fcf(uint8_t *data, frame802154_fcf_t *pfcf)
   memcpy(pfcf, &fcf, sizeof(frame802154_fcf_t));
 }
 /*----------------------------------------------------------------------------*/
+#if FRAME802154_PARSE_FAST
+/* Parse a data frame of frame version 2003 or 2006 with a sequence
+ * number, no security and no IEs, and the PAN ID compressed between two
+ * long or two short addresses. Returns the header length, or 0 if the
+ * frame has another shape. */
+static int
+parse_fast(uint8_t *data, int len, frame802154_t *pf)
+{
+  int l;
+  int c;
+  uint8_t *p;
+
+  /* Data frame, no security, PAN ID compression; any pending or ack bit */
+  if((data[0] & 0xcf) != 0x41) {
+    return 0;
+  }
+  /* Sequence number, no IEs, frame version 0 or 1, same address modes */
+  if((data[1] & 0xef) == 0xcc) {
+    l = 8;
+  } else if((data[1] & 0xef) == 0x88) {
+    l = 2;
+  } else {
+    return 0;
+  }
+  if(len < 2 + 1 + 2 + 2 * l) {
+    return 0;
+  }
+
+  frame802154_parse_fcf(data, &pf->fcf);
+  pf->seq = data[2];
+  pf->dest_pid = data[3] + (data[4] << 8);
+  pf->src_pid = pf->dest_pid;
+  p = data + 5;
+  if(l == 2) {
+    linkaddr_copy((linkaddr_t *)&(pf->dest_addr), &linkaddr_null);
+    linkaddr_copy((linkaddr_t *)&(pf->src_addr), &linkaddr_null);
+  }
+  for(c = 0; c < l; c++) {
+    pf->dest_addr[c] = p[l - 1 - c];
+    pf->src_addr[c] = p[2 * l - 1 - c];
+  }
+  p += 2 * l;
+
+  c = p - data;
+  pf->payload_len = len - c;
+  pf->payload = p;
+  return c;
+}
+#endif /* FRAME802154_PARSE_FAST */
+/*----------------------------------------------------------------------------*/
 /**
  *   \brief Parses an input frame.  Scans the input frame to find each
  *   section, and stores the information of each section in a
@@ -512,6 +562,13 @@ frame802154_parse(uint8_t *data, int len, frame802154_t *pf)
     return 0;
   }
 
+#if FRAME802154_PARSE_FAST
+  c = parse_fast(data, len, pf);
+  if(c > 0) {
+    return c;
+  }
+#endif /* FRAME802154_PARSE_FAST */
+
   p = data;
 
   /* decode the FCF */
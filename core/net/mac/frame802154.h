@@ -86,6 +86,15 @@
 #define FRAME802154_SUPPR_SEQNO 0
 #endif /* FRAME802154_CONF_SUPPR_SEQNO */
 
+/* Parse the usual data frame, with a sequence number, no security and
+ * both addresses of the same size behind a single PAN ID, without
+ * going through the general rules for each field */
+#ifdef FRAME802154_CONF_PARSE_FAST
+#define FRAME802154_PARSE_FAST FRAME802154_CONF_PARSE_FAST
+#else /* FRAME802154_CONF_PARSE_FAST */
+#define FRAME802154_PARSE_FAST 0
+#endif /* FRAME802154_CONF_PARSE_FAST */
+
 /* Macros & Defines */
 
 /** \brief These are some definitions of values used in the FCF.  See the 802.15.4 spec for details.
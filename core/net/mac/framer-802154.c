@@ -62,25 +62,201 @@ static uint8_t mac_dsn;
 
 static uint8_t initialized = 0;
 
+#if FRAMER_802154_HDR_CACHE
+/* Longest header: FCF, sequence number, PAN IDs, long addresses and
+   auxiliary security header */
+#define HDR_MAX_LEN (2 + 1 + 2 + 8 + 2 + 8 + 14)
+
+/* What a header depends on, besides the sequence number and frame
+   counter */
+struct hdr_key {
+  linkaddr_t dest;
+  linkaddr_t src;
+  uint16_t pan_id;
+  uint8_t frame_type;
+  uint8_t pending;
+  uint8_t ack;
+#if LLSEC802154_USES_AUX_HEADER
+  uint8_t security_level;
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  uint8_t key_id_mode;
+  uint8_t key_index;
+  uint16_t key_source;
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+};
+
+struct hdr_template {
+  struct hdr_key key;
+  uint8_t len;        /* header length, zero if the entry is unused */
+  uint8_t seqno_pos;  /* zero if the sequence number is suppressed */
+  uint8_t counter_pos; /* zero if there is no frame counter */
+  uint8_t hdr[HDR_MAX_LEN];
+};
+
+static struct hdr_template hdr_cache[FRAMER_802154_HDR_CACHE];
+/* The entry to replace next */
+static uint8_t hdr_cache_next;
+#endif /* FRAMER_802154_HDR_CACHE */
+
+/*---------------------------------------------------------------------------*/
+/* Get the sequence number of the frame in the packetbuf, giving it a
+   new one if it has none yet */
+static uint8_t
+get_seqno(void)
+{
+  uint8_t seq;
+
+  if(packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO)) {
+    return packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO);
+  }
+  /* Ensure that the sequence number 0 is not used as it would bypass the above check. */
+  if(mac_dsn == 0) {
+    mac_dsn++;
+  }
+  seq = mac_dsn++;
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, seq);
+  return seq;
+}
+/*---------------------------------------------------------------------------*/
+#if FRAMER_802154_HDR_CACHE
+static void
+hdr_key_from_packetbuf(struct hdr_key *key)
+{
+  /* Clear the padding too, keys are compared with memcmp */
+  memset(key, 0, sizeof(*key));
+  linkaddr_copy(&key->dest, packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+  linkaddr_copy(&key->src, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  key->pan_id = frame802154_get_pan_id();
+  key->frame_type = packetbuf_attr(PACKETBUF_ATTR_FRAME_TYPE);
+  key->pending = packetbuf_attr(PACKETBUF_ATTR_PENDING);
+  key->ack = packetbuf_attr(PACKETBUF_ATTR_MAC_ACK);
+#if LLSEC802154_USES_AUX_HEADER
+  key->security_level = packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  key->key_id_mode = packetbuf_attr(PACKETBUF_ATTR_KEY_ID_MODE);
+  key->key_index = packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX);
+  key->key_source = packetbuf_attr(PACKETBUF_ATTR_KEY_SOURCE_BYTES_0_1);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+}
+/*---------------------------------------------------------------------------*/
+static struct hdr_template *
+hdr_cache_lookup(const struct hdr_key *key)
+{
+  int i;
+
+  for(i = 0; i < FRAMER_802154_HDR_CACHE; i++) {
+    if(hdr_cache[i].len != 0 &&
+       memcmp(&hdr_cache[i].key, key, sizeof(*key)) == 0) {
+      return &hdr_cache[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Keep the header just created as the template for its key */
+static void
+hdr_cache_add(const struct hdr_key *key, const frame802154_t *params,
+              const uint8_t *hdr, int hdr_len)
+{
+  struct hdr_template *t;
+
+  if(hdr_len > HDR_MAX_LEN) {
+    return;
+  }
+  t = &hdr_cache[hdr_cache_next];
+  hdr_cache_next = (hdr_cache_next + 1) % FRAMER_802154_HDR_CACHE;
+
+  memcpy(&t->key, key, sizeof(*key));
+  memcpy(t->hdr, hdr, hdr_len);
+  t->len = hdr_len;
+  t->seqno_pos = params->fcf.sequence_number_suppression ? 0 : 2;
+  t->counter_pos = 0;
+#if LLSEC802154_USES_AUX_HEADER && LLSEC802154_USES_FRAME_COUNTER
+  if(params->fcf.security_enabled) {
+    /* The frame counter follows the security control field, and is
+       followed by the key identifier, if any */
+    t->counter_pos = hdr_len - 4;
+#if LLSEC802154_USES_EXPLICIT_KEYS
+    if(params->aux_hdr.security_control.key_id_mode) {
+      t->counter_pos -= (params->aux_hdr.security_control.key_id_mode - 1) * 4 + 1;
+    }
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+  }
+#endif /* LLSEC802154_USES_AUX_HEADER && LLSEC802154_USES_FRAME_COUNTER */
+}
+/*---------------------------------------------------------------------------*/
+/* Create the frame from a cached header, if there is one for it */
+static int
+create_from_cache(const struct hdr_key *key, int do_create)
+{
+  struct hdr_template *t;
+  uint8_t *hdr;
+  uint8_t seq;
+#if LLSEC802154_USES_AUX_HEADER && LLSEC802154_USES_FRAME_COUNTER
+  frame802154_frame_counter_t counter;
+#endif /* LLSEC802154_USES_AUX_HEADER && LLSEC802154_USES_FRAME_COUNTER */
+
+  t = hdr_cache_lookup(key);
+  if(t == NULL) {
+    return 0;
+  }
+  if(!do_create) {
+    return t->len;
+  }
+  if(!packetbuf_hdralloc(t->len)) {
+    PRINTF("15.4-OUT: too large header: %u\n", t->len);
+    return FRAMER_FAILED;
+  }
+  hdr = packetbuf_hdrptr();
+  memcpy(hdr, t->hdr, t->len);
+  /* As in create_frame(), a sequence number is taken even if the
+     frame does not carry it */
+  seq = get_seqno();
+  if(t->seqno_pos != 0) {
+    hdr[t->seqno_pos] = seq;
+  }
+#if LLSEC802154_USES_AUX_HEADER && LLSEC802154_USES_FRAME_COUNTER
+  if(t->counter_pos != 0) {
+    counter.u16[0] = packetbuf_attr(PACKETBUF_ATTR_FRAME_COUNTER_BYTES_0_1);
+    counter.u16[1] = packetbuf_attr(PACKETBUF_ATTR_FRAME_COUNTER_BYTES_2_3);
+    memcpy(hdr + t->counter_pos, counter.u8, 4);
+  }
+#endif /* LLSEC802154_USES_AUX_HEADER && LLSEC802154_USES_FRAME_COUNTER */
+  return t->len;
+}
+#endif /* FRAMER_802154_HDR_CACHE */
 /*---------------------------------------------------------------------------*/
 static int
 create_frame(int type, int do_create)
 {
   frame802154_t params;
   int hdr_len;
+#if FRAMER_802154_HDR_CACHE
+  struct hdr_key key;
+#endif /* FRAMER_802154_HDR_CACHE */
 
   if(frame802154_get_pan_id() == 0xffff) {
     return -1;
   }
 
-  /* init to zeros */
-  memset(&params, 0, sizeof(params));
-
   if(!initialized) {
     initialized = 1;
     mac_dsn = random_rand() & 0xff;
   }
 
+#if FRAMER_802154_HDR_CACHE
+  hdr_key_from_packetbuf(&key);
+  hdr_len = create_from_cache(&key, do_create);
+  if(hdr_len != 0) {
+    return hdr_len;
+  }
+#endif /* FRAMER_802154_HDR_CACHE */
+
+  /* init to zeros */
+  memset(&params, 0, sizeof(params));
+
   /* Build the FCF. */
   params.fcf.frame_type = packetbuf_attr(PACKETBUF_ATTR_FRAME_TYPE);
   params.fcf.frame_pending = packetbuf_attr(PACKETBUF_ATTR_PENDING);
@@ -125,16 +301,8 @@ create_frame(int type, int do_create)
     /* Only length calculation - no sequence number is needed and
        should not be consumed. */
 
-  } else if(packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO)) {
-    params.seq = packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO);
-
   } else {
-    /* Ensure that the sequence number 0 is not used as it would bypass the above check. */
-    if(mac_dsn == 0) {
-      mac_dsn++;
-    }
-    params.seq = mac_dsn++;
-    packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, params.seq);
+    params.seq = get_seqno();
   }
 
   /* Complete the addressing fields. */
@@ -184,6 +352,9 @@ create_frame(int type, int do_create)
     return hdr_len;
   } else if(packetbuf_hdralloc(hdr_len)) {
     frame802154_create(&params, packetbuf_hdrptr());
+#if FRAMER_802154_HDR_CACHE
+    hdr_cache_add(&key, &params, packetbuf_hdrptr(), hdr_len);
+#endif /* FRAMER_802154_HDR_CACHE */
 
     PRINTF("15.4-OUT: %2X", params.fcf.frame_type);
     PRINTADDR(params.dest_addr);
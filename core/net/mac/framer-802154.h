@@ -41,6 +41,16 @@
 
 #include "net/mac/framer.h"
 
+/* Number of frame headers kept as templates. A frame to the same
+   destination, of the same type and with the same security settings as
+   a cached header gets a copy of it, with only the sequence number and
+   frame counter filled in. */
+#ifdef FRAMER_802154_CONF_HDR_CACHE
+#define FRAMER_802154_HDR_CACHE FRAMER_802154_CONF_HDR_CACHE
+#else /* FRAMER_802154_CONF_HDR_CACHE */
+#define FRAMER_802154_HDR_CACHE 0
+#endif /* FRAMER_802154_CONF_HDR_CACHE */
+
 extern const struct framer framer_802154;
 
 #endif /* FRAMER_802154_H_ */
@@ -129,9 +129,9 @@ send_one_packet(mac_callback_t sent, void *ptr)
 #if NULLRDC_802154_AUTOACK
     int is_broadcast;
     uint8_t dsn;
-    dsn = ((uint8_t *)packetbuf_hdrptr())[2] & 0xff;
+    dsn = ((const uint8_t *)packetbuf_const_hdrptr())[2] & 0xff;
 
-    NETSTACK_RADIO.prepare(packetbuf_hdrptr(), packetbuf_totlen());
+    NETSTACK_RADIO.prepare(packetbuf_const_hdrptr(), packetbuf_totlen());
 
     is_broadcast = packetbuf_holds_broadcast();
 
@@ -210,7 +210,7 @@ send_one_packet(mac_callback_t sent, void *ptr)
 
 #else /* ! NULLRDC_802154_AUTOACK */
 
-    switch(NETSTACK_RADIO.send(packetbuf_hdrptr(), packetbuf_totlen())) {
+    switch(NETSTACK_RADIO.send(packetbuf_const_hdrptr(), packetbuf_totlen())) {
     case RADIO_TX_OK:
       ret = MAC_TX_OK;
       break;
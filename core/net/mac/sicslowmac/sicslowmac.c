@@ -161,7 +161,7 @@ send_packet(mac_callback_t sent, void *ptr)
     PRINTADDR(params.dest_addr);
     PRINTF("%u %u (%u)\n", len, packetbuf_datalen(), packetbuf_totlen());
 
-    ret = NETSTACK_RADIO.send(packetbuf_hdrptr(), packetbuf_totlen());
+    ret = NETSTACK_RADIO.send(packetbuf_const_hdrptr(), packetbuf_totlen());
     if(sent) {
       switch(ret) {
       case RADIO_TX_OK:
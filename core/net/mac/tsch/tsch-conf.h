@@ -170,6 +170,15 @@
 #define TSCH_WITH_LINK_SELECTOR 0
 #endif /* TSCH_CONF_WITH_LINK_SELECTOR */
 
+/* Number of traffic classes in each neighbor queue. Upper layers put
+ * packets in a class through the PACKETBUF_ATTR_TSCH_CLASS attribute,
+ * and higher classes are sent first. See tsch-queue.h */
+#ifdef TSCH_QUEUE_CONF_CLASSES
+#define TSCH_QUEUE_CLASSES TSCH_QUEUE_CONF_CLASSES
+#else /* TSCH_QUEUE_CONF_CLASSES */
+#define TSCH_QUEUE_CLASSES 1
+#endif /* TSCH_QUEUE_CONF_CLASSES */
+
 /* Estimate the drift of the time-source neighbor and compensate for it? */
 #ifdef TSCH_CONF_ADAPTIVE_TIMESYNC
 #define TSCH_ADAPTIVE_TIMESYNC TSCH_CONF_ADAPTIVE_TIMESYNC
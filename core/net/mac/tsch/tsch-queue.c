@@ -45,6 +45,7 @@
 #include "contiki.h"
 #include "lib/list.h"
 #include "lib/memb.h"
+#include "lib/hashindex.h"
 #include "lib/random.h"
 #include "net/queuebuf.h"
 #include "net/mac/rdc.h"
@@ -77,12 +78,196 @@ LIST(neighbor_list);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_STATS
+struct tsch_queue_stats tsch_queue_stats[TSCH_QUEUE_CLASSES];
+#endif /* TSCH_QUEUE_STATS */
+
+#ifdef TSCH_QUEUE_CLASS_WEIGHTS
+static const uint8_t class_weights[TSCH_QUEUE_CLASSES] = TSCH_QUEUE_CLASS_WEIGHTS;
+/* Look for a packet in the classes with some share left, then in the others */
+#define CLASS_PASSES 2
+#else /* TSCH_QUEUE_CLASS_WEIGHTS */
+#define CLASS_PASSES 1
+#endif /* TSCH_QUEUE_CLASS_WEIGHTS */
+
+#if TSCH_QUEUE_READY_LIST
+/* Unicast neighbors with no tx link, which send over shared links only:
+ * those with packets and no backoff, in the order they became ready, and
+ * those in backoff. The lists are changed from slot operation only, or
+ * with the TSCH lock. A neighbor may stay on a list after it no longer
+ * belongs there, and is dropped the next time the list is walked. */
+static struct tsch_neighbor *ready_head, *ready_tail;
+static struct tsch_neighbor *backoff_head;
+/* Neighbors to be checked for the lists by slot operation. Filled in
+ * outside of slot operation, as a lock-free ring buffer. */
+#define CHECK_NUM 16
+static struct tsch_neighbor *check_array[CHECK_NUM];
+static struct ringbufindex check_ringbuf;
+/* Set when the ring buffer was full: check all neighbors */
+static volatile uint8_t check_all;
+#endif /* TSCH_QUEUE_READY_LIST */
+
+/*---------------------------------------------------------------------------*/
+/* Are the queues of all classes empty? */
+static int
+queue_empty(const struct tsch_neighbor *n)
+{
+  int c;
+  for(c = 0; c < TSCH_QUEUE_CLASSES; c++) {
+    if(!ringbufindex_empty(&n->tx_ringbuf[c])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+#if TSCH_QUEUE_CLASSES > 1
+/* Get the class of the packet in packetbuf */
+static uint8_t
+packetbuf_class(void)
+{
+  packetbuf_attr_t c = packetbuf_attr(PACKETBUF_ATTR_TSCH_CLASS);
+  return c < TSCH_QUEUE_CLASSES ? c : TSCH_QUEUE_CLASSES - 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Get the class to remove a packet from: that of the packet last picked
+ * for the neighbor, or the highest one with packets */
+static uint8_t
+removal_class(const struct tsch_neighbor *n)
+{
+  int c;
+  if(!ringbufindex_empty(&n->tx_ringbuf[n->tx_class])) {
+    return n->tx_class;
+  }
+  for(c = TSCH_QUEUE_CLASSES - 1; c > 0; c--) {
+    if(!ringbufindex_empty(&n->tx_ringbuf[c])) {
+      break;
+    }
+  }
+  return c;
+}
+#else /* TSCH_QUEUE_CLASSES > 1 */
+#define packetbuf_class() 0
+#define removal_class(n) 0
+#endif /* TSCH_QUEUE_CLASSES > 1 */
+/*---------------------------------------------------------------------------*/
+#if TSCH_QUEUE_HASH
+#define NBR_FROM_INDEX(i) (&((struct tsch_neighbor *)neighbor_memb.mem)[i])
+#define INDEX_FROM_NBR(n) ((n) - (struct tsch_neighbor *)neighbor_memb.mem)
+
+/* Get the address of a neighbor index */
+static const void *
+addr_from_index(uint16_t index)
+{
+  return &NBR_FROM_INDEX(index)->addr;
+}
+/* Hash index over the addresses of the neighbors on the list. Changed
+ * only with the TSCH lock, like the list. */
+HASHINDEX(addr_index, TSCH_QUEUE_MAX_NEIGHBOR_QUEUES, LINKADDR_SIZE,
+          addr_from_index);
+#define hash_insert(n) hashindex_add(&addr_index, INDEX_FROM_NBR(n))
+#define hash_remove(n) hashindex_remove(&addr_index, INDEX_FROM_NBR(n))
+#else /* TSCH_QUEUE_HASH */
+#define hash_insert(n)
+#define hash_remove(n)
+#endif /* TSCH_QUEUE_HASH */
+/*---------------------------------------------------------------------------*/
+#if TSCH_QUEUE_READY_LIST
+/* Put a neighbor on the list it belongs to, if any. From slot operation
+ * or with the TSCH lock only. */
+static void
+ready_check(struct tsch_neighbor *n)
+{
+  if(n->is_broadcast || n->tx_links_count != 0) {
+    return;
+  }
+  if(n->backoff_window != 0) {
+    if(!n->in_backoff) {
+      n->in_backoff = 1;
+      n->next_backoff = backoff_head;
+      backoff_head = n;
+    }
+  } else if(!n->is_ready && !queue_empty(n)) {
+    n->is_ready = 1;
+    n->next_ready = NULL;
+    if(ready_tail != NULL) {
+      ready_tail->next_ready = n;
+    } else {
+      ready_head = n;
+    }
+    ready_tail = n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Have slot operation check a neighbor. Outside of slot operation only. */
+static void
+ready_request_check(struct tsch_neighbor *n)
+{
+  int16_t put_index = ringbufindex_peek_put(&check_ringbuf);
+  if(put_index != -1) {
+    check_array[put_index] = n;
+    ringbufindex_put(&check_ringbuf);
+  } else {
+    check_all = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Check the neighbors requested from outside of slot operation */
+static void
+ready_check_requested(void)
+{
+  int16_t get_index;
+
+  while((get_index = ringbufindex_get(&check_ringbuf)) != -1) {
+    ready_check(check_array[get_index]);
+  }
+  if(check_all) {
+    struct tsch_neighbor *n;
+    check_all = 0;
+    for(n = list_head(neighbor_list); n != NULL; n = list_item_next(n)) {
+      ready_check(n);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Take a neighbor off both lists, with the TSCH lock */
+static void
+ready_remove(struct tsch_neighbor *n)
+{
+  struct tsch_neighbor **np;
+  struct tsch_neighbor *prev = NULL;
+
+  for(np = &ready_head; *np != NULL; prev = *np, np = &(*np)->next_ready) {
+    if(*np == n) {
+      *np = n->next_ready;
+      if(ready_tail == n) {
+        ready_tail = prev;
+      }
+      break;
+    }
+  }
+  for(np = &backoff_head; *np != NULL; np = &(*np)->next_backoff) {
+    if(*np == n) {
+      *np = n->next_backoff;
+      break;
+    }
+  }
+  /* The neighbor may still be waiting to be checked: check all instead */
+  while(ringbufindex_get(&check_ringbuf) != -1);
+  check_all = 1;
+}
+#else /* TSCH_QUEUE_READY_LIST */
+#define ready_check(n)
+#define ready_request_check(n)
+#define ready_remove(n)
+#endif /* TSCH_QUEUE_READY_LIST */
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
 tsch_queue_add_nbr(const linkaddr_t *addr)
 {
   struct tsch_neighbor *n = NULL;
+  int c;
   /* If we have an entry for this neighbor already, we simply update it */
   n = tsch_queue_get_nbr(addr);
   if(n == NULL) {
@@ -92,13 +277,19 @@ tsch_queue_add_nbr(const linkaddr_t *addr)
       if(n != NULL) {
         /* Initialize neighbor entry */
         memset(n, 0, sizeof(struct tsch_neighbor));
-        ringbufindex_init(&n->tx_ringbuf, TSCH_QUEUE_NUM_PER_NEIGHBOR);
+        for(c = 0; c < TSCH_QUEUE_CLASSES; c++) {
+          ringbufindex_init(&n->tx_ringbuf[c], TSCH_QUEUE_NUM_PER_NEIGHBOR);
+        }
+#ifdef TSCH_QUEUE_CLASS_WEIGHTS
+        memcpy(n->tx_credits, class_weights, sizeof(n->tx_credits));
+#endif /* TSCH_QUEUE_CLASS_WEIGHTS */
         linkaddr_copy(&n->addr, addr);
         n->is_broadcast = linkaddr_cmp(addr, &tsch_eb_address)
           || linkaddr_cmp(addr, &tsch_broadcast_address);
         tsch_queue_backoff_reset(n);
         /* Add neighbor to the list */
         list_add(neighbor_list, n);
+        hash_insert(n);
       }
       tsch_release_lock();
     }
@@ -111,6 +302,12 @@ struct tsch_neighbor *
 tsch_queue_get_nbr(const linkaddr_t *addr)
 {
   if(!tsch_is_locked()) {
+#if TSCH_QUEUE_HASH
+    int index = hashindex_lookup(&addr_index, addr);
+    if(index >= 0) {
+      return NBR_FROM_INDEX(index);
+    }
+#else /* TSCH_QUEUE_HASH */
     struct tsch_neighbor *n = list_head(neighbor_list);
     while(n != NULL) {
       if(linkaddr_cmp(&n->addr, addr)) {
@@ -118,6 +315,7 @@ tsch_queue_get_nbr(const linkaddr_t *addr)
       }
       n = list_item_next(n);
     }
+#endif /* TSCH_QUEUE_HASH */
   }
   return NULL;
 }
@@ -215,6 +413,8 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
 
       /* Remove neighbor from list */
       list_remove(neighbor_list, n);
+      hash_remove(n);
+      ready_remove(n);
 
       tsch_release_lock();
 
@@ -237,33 +437,43 @@ tsch_queue_add_packet(const linkaddr_t *addr, mac_callback_t sent, void *ptr)
   if(!tsch_is_locked()) {
     n = tsch_queue_add_nbr(addr);
     if(n != NULL) {
-      put_index = ringbufindex_peek_put(&n->tx_ringbuf);
-      if(put_index != -1) {
-        p = memb_alloc(&packet_memb);
-        if(p != NULL) {
-          /* Enqueue packet */
+      p = memb_alloc(&packet_memb);
+      if(p != NULL) {
+        uint8_t c;
+        /* Let upper layers set the attributes of the packet, including
+         * its class, before picking the queue */
 #ifdef TSCH_CALLBACK_PACKET_READY
-          TSCH_CALLBACK_PACKET_READY();
+        TSCH_CALLBACK_PACKET_READY();
 #endif
+        c = packetbuf_class();
+        put_index = ringbufindex_peek_put(&n->tx_ringbuf[c]);
+        if(put_index != -1) {
+          /* Enqueue packet */
           p->qb = queuebuf_new_from_packetbuf();
           if(p->qb != NULL) {
             p->sent = sent;
             p->ptr = ptr;
             p->ret = MAC_TX_DEFERRED;
             p->transmissions = 0;
+#if TSCH_QUEUE_STATS
+            p->queued_at = clock_time();
+#endif /* TSCH_QUEUE_STATS */
             /* Add to ringbuf (actual add committed through atomic operation) */
-            n->tx_array[put_index] = p;
-            ringbufindex_put(&n->tx_ringbuf);
+            n->tx_array[c][put_index] = p;
+            ringbufindex_put(&n->tx_ringbuf[c]);
+            ready_request_check(n);
             PRINTF("TSCH-queue: packet is added put_index=%u, packet=%p\n",
                    put_index, p);
             return p;
-          } else {
-            memb_free(&packet_memb, p);
           }
         }
+        memb_free(&packet_memb, p);
       }
     }
   }
+#if TSCH_QUEUE_STATS
+  tsch_queue_stats[packetbuf_class()].dropped++;
+#endif /* TSCH_QUEUE_STATS */
   PRINTF("TSCH-queue:! add packet failed: %u %p %d %p %p\n", tsch_is_locked(), n, put_index, p, p ? p->qb : NULL);
   return 0;
 }
@@ -276,7 +486,12 @@ tsch_queue_packet_count(const linkaddr_t *addr)
   if(!tsch_is_locked()) {
     n = tsch_queue_add_nbr(addr);
     if(n != NULL) {
-      return ringbufindex_elements(&n->tx_ringbuf);
+      int c;
+      int count = 0;
+      for(c = 0; c < TSCH_QUEUE_CLASSES; c++) {
+        count += ringbufindex_elements(&n->tx_ringbuf[c]);
+      }
+      return count;
     }
   }
   return -1;
@@ -289,10 +504,33 @@ tsch_queue_remove_packet_from_queue(struct tsch_neighbor *n)
   if(!tsch_is_locked()) {
     if(n != NULL) {
       /* Get and remove packet from ringbuf (remove committed through an atomic operation */
-      int16_t get_index = ringbufindex_get(&n->tx_ringbuf);
+      uint8_t c = removal_class(n);
+      int16_t get_index = ringbufindex_get(&n->tx_ringbuf[c]);
       if(get_index != -1) {
+        struct tsch_packet *p = n->tx_array[c][get_index];
+#if TSCH_QUEUE_STATS
+        clock_time_t latency = clock_time() - p->queued_at;
+        if(p->ret == MAC_TX_OK) {
+          tsch_queue_stats[c].sent++;
+        } else {
+          tsch_queue_stats[c].dropped++;
+        }
+        tsch_queue_stats[c].latency += latency;
+        if(latency > tsch_queue_stats[c].max_latency) {
+          tsch_queue_stats[c].max_latency = latency;
+        }
+#endif /* TSCH_QUEUE_STATS */
+#ifdef TSCH_QUEUE_CLASS_WEIGHTS
+        if(n->tx_credits[c] == 0) {
+          /* The class has used up its share: start a new round */
+          memcpy(n->tx_credits, class_weights, sizeof(n->tx_credits));
+        }
+        if(n->tx_credits[c] != 0) {
+          n->tx_credits[c]--;
+        }
+#endif /* TSCH_QUEUE_CLASS_WEIGHTS */
         PRINTF("TSCH-queue: packet is removed, get_index=%u\n", get_index);
-        return n->tx_array[get_index];
+        return p;
       } else {
         return NULL;
       }
@@ -353,31 +591,47 @@ tsch_queue_free_unused_neighbors(void)
 int
 tsch_queue_is_empty(const struct tsch_neighbor *n)
 {
-  return !tsch_is_locked() && n != NULL && ringbufindex_empty(&n->tx_ringbuf);
+  return !tsch_is_locked() && n != NULL && queue_empty(n);
 }
 /*---------------------------------------------------------------------------*/
 /* Returns the first packet from a neighbor queue */
 struct tsch_packet *
-tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *link)
+tsch_queue_get_packet_for_nbr(struct tsch_neighbor *n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
     int is_shared_link = link != NULL && link->link_options & LINK_OPTION_SHARED;
-    if(n != NULL) {
-      int16_t get_index = ringbufindex_peek_get(&n->tx_ringbuf);
-      if(get_index != -1 &&
-          !(is_shared_link && !tsch_queue_backoff_expired(n))) {    /* If this is a shared link,
-                                                                    make sure the backoff has expired */
+    if(n != NULL &&
+        !(is_shared_link && !tsch_queue_backoff_expired(n))) {    /* If this is a shared link,
+                                                                  make sure the backoff has expired */
+      int pass;
+      int c;
+      /* Look at the head packet of each class, highest first */
+      for(pass = 0; pass < CLASS_PASSES; pass++) {
+        for(c = TSCH_QUEUE_CLASSES - 1; c >= 0; c--) {
+          int16_t get_index;
+#ifdef TSCH_QUEUE_CLASS_WEIGHTS
+          if((n->tx_credits[c] != 0) != (pass == 0)) {
+            continue;
+          }
+#endif /* TSCH_QUEUE_CLASS_WEIGHTS */
+          get_index = ringbufindex_peek_get(&n->tx_ringbuf[c]);
+          if(get_index != -1) {
 #if TSCH_WITH_LINK_SELECTOR
-        int packet_attr_slotframe = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
-        int packet_attr_timeslot = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
-        if(packet_attr_slotframe != 0xffff && packet_attr_slotframe != link->slotframe_handle) {
-          return NULL;
-        }
-        if(packet_attr_timeslot != 0xffff && packet_attr_timeslot != link->timeslot) {
-          return NULL;
-        }
+            int packet_attr_slotframe = queuebuf_attr(n->tx_array[c][get_index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
+            int packet_attr_timeslot = queuebuf_attr(n->tx_array[c][get_index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
+            if(packet_attr_slotframe != 0xffff && packet_attr_slotframe != link->slotframe_handle) {
+              continue;
+            }
+            if(packet_attr_timeslot != 0xffff && packet_attr_timeslot != link->timeslot) {
+              continue;
+            }
 #endif
-        return n->tx_array[get_index];
+#if TSCH_QUEUE_CLASSES > 1
+            n->tx_class = c;
+#endif /* TSCH_QUEUE_CLASSES > 1 */
+            return n->tx_array[c][get_index];
+          }
+        }
       }
     }
   }
@@ -400,6 +654,39 @@ struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
+#if TSCH_QUEUE_READY_LIST
+    struct tsch_neighbor *curr_nbr;
+    struct tsch_neighbor *prev_nbr = NULL;
+    struct tsch_packet *p = NULL;
+    ready_check_requested();
+    curr_nbr = ready_head;
+    while(curr_nbr != NULL) {
+      struct tsch_neighbor *next_nbr = curr_nbr->next_ready;
+      if(curr_nbr->tx_links_count != 0 || !tsch_queue_backoff_expired(curr_nbr)
+         || queue_empty(curr_nbr)) {
+        /* No longer ready, drop it from the list */
+        curr_nbr->is_ready = 0;
+        if(prev_nbr != NULL) {
+          prev_nbr->next_ready = next_nbr;
+        } else {
+          ready_head = next_nbr;
+        }
+        if(ready_tail == curr_nbr) {
+          ready_tail = prev_nbr;
+        }
+      } else {
+        p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
+        if(p != NULL) {
+          if(n != NULL) {
+            *n = curr_nbr;
+          }
+          return p;
+        }
+        prev_nbr = curr_nbr;
+      }
+      curr_nbr = next_nbr;
+    }
+#else /* TSCH_QUEUE_READY_LIST */
     struct tsch_neighbor *curr_nbr = list_head(neighbor_list);
     struct tsch_packet *p = NULL;
     while(curr_nbr != NULL) {
@@ -415,6 +702,7 @@ tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link
       }
       curr_nbr = list_item_next(curr_nbr);
     }
+#endif /* TSCH_QUEUE_READY_LIST */
   }
   return NULL;
 }
@@ -432,6 +720,8 @@ tsch_queue_backoff_reset(struct tsch_neighbor *n)
 {
   n->backoff_window = 0;
   n->backoff_exponent = TSCH_MAC_MIN_BE;
+  /* Only reaches a list from slot operation: elsewhere, the queue is empty */
+  ready_check(n);
 }
 /*---------------------------------------------------------------------------*/
 /* Increment backoff exponent, pick a new window */
@@ -447,6 +737,7 @@ tsch_queue_backoff_inc(struct tsch_neighbor *n)
   /* Add one to the window as we will decrement it at the end of the current slot
    * through tsch_queue_update_all_backoff_windows */
   n->backoff_window++;
+  ready_check(n);
 }
 /*---------------------------------------------------------------------------*/
 /* Decrement backoff window for all queues directed at dest_addr */
@@ -455,6 +746,32 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
 {
   if(!tsch_is_locked()) {
     int is_broadcast = linkaddr_cmp(dest_addr, &tsch_broadcast_address);
+#if TSCH_QUEUE_READY_LIST
+    struct tsch_neighbor *n;
+    if(is_broadcast) {
+      /* Neighbors with no tx link, from the backoff list */
+      struct tsch_neighbor **np = &backoff_head;
+      ready_check_requested();
+      while((n = *np) != NULL) {
+        if(n->backoff_window != 0 && n->tx_links_count == 0) {
+          n->backoff_window--;
+        }
+        if(n->backoff_window == 0 || n->tx_links_count != 0) {
+          /* Out of backoff: drop it from the list, it may now be ready */
+          *np = n->next_backoff;
+          n->in_backoff = 0;
+          ready_check(n);
+        } else {
+          np = &n->next_backoff;
+        }
+      }
+    } else {
+      n = tsch_queue_get_nbr(dest_addr);
+      if(n != NULL && n->backoff_window != 0 && n->tx_links_count > 0) {
+        n->backoff_window--;
+      }
+    }
+#else /* TSCH_QUEUE_READY_LIST */
     struct tsch_neighbor *n = list_head(neighbor_list);
     while(n != NULL) {
       if(n->backoff_window != 0 /* Is the queue in backoff state? */
@@ -464,9 +781,18 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
       }
       n = list_item_next(n);
     }
+#endif /* TSCH_QUEUE_READY_LIST */
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Recheck whether a neighbor may send over shared links, after changing
+ * its tx links. Call outside of slot operation. */
+void
+tsch_queue_update_nbr(struct tsch_neighbor *n)
+{
+  ready_request_check(n);
+}
+/*---------------------------------------------------------------------------*/
 /* Initialize TSCH queue module */
 void
 tsch_queue_init(void)
@@ -474,6 +800,14 @@ tsch_queue_init(void)
   list_init(neighbor_list);
   memb_init(&neighbor_memb);
   memb_init(&packet_memb);
+#if TSCH_QUEUE_HASH
+  hashindex_init(&addr_index);
+#endif /* TSCH_QUEUE_HASH */
+#if TSCH_QUEUE_READY_LIST
+  ready_head = ready_tail = backoff_head = NULL;
+  ringbufindex_init(&check_ringbuf, CHECK_NUM);
+  check_all = 0;
+#endif /* TSCH_QUEUE_READY_LIST */
   /* Add virtual EB and the broadcast neighbors */
   n_eb = tsch_queue_add_nbr(&tsch_eb_address);
   n_broadcast = tsch_queue_add_nbr(&tsch_broadcast_address);
@@ -77,6 +77,47 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Look neighbors up by address through an open-addressed hash index
+ * rather than by walking the list of neighbors. Costs two bytes per
+ * neighbor queue, four with 255 queues or more. */
+#ifdef TSCH_QUEUE_CONF_HASH
+#define TSCH_QUEUE_HASH TSCH_QUEUE_CONF_HASH
+#else
+#define TSCH_QUEUE_HASH 0
+#endif
+
+/* Keep the neighbors that may send over a shared link, and those in
+ * backoff, on lists of their own, so that slot operation does not go
+ * through every neighbor to pick a packet or to update backoff windows */
+#ifdef TSCH_QUEUE_CONF_READY_LIST
+#define TSCH_QUEUE_READY_LIST TSCH_QUEUE_CONF_READY_LIST
+#else
+#define TSCH_QUEUE_READY_LIST 0
+#endif
+
+/* With more than one traffic class (TSCH_QUEUE_CONF_CLASSES), each
+ * neighbor has a queue of TSCH_QUEUE_NUM_PER_NEIGHBOR packets per class.
+ * The class is the PACKETBUF_ATTR_TSCH_CLASS attribute of the packet,
+ * class 0 being the default. 6LoWPAN puts RPL control messages (DIS,
+ * DIO, DAO) and TSCH its keepalives in the highest class. Other traffic
+ * is classified from TSCH_CALLBACK_PACKET_READY, which is called before
+ * the packet is queued and may also override these defaults. Higher
+ * classes are sent first. If weights are given, e.g. { 1, 4 }, each
+ * class instead gets a share of the transmissions to a neighbor in
+ * proportion to its weight, its packets still going first while it has
+ * some share left. */
+#ifdef TSCH_QUEUE_CONF_CLASS_WEIGHTS
+#define TSCH_QUEUE_CLASS_WEIGHTS TSCH_QUEUE_CONF_CLASS_WEIGHTS
+#endif
+
+/* Keep per-class counts of packets sent and dropped, and of the time
+ * they spent in the queues */
+#ifdef TSCH_QUEUE_CONF_STATS
+#define TSCH_QUEUE_STATS TSCH_QUEUE_CONF_STATS
+#else
+#define TSCH_QUEUE_STATS 0
+#endif
+
 /* TSCH CSMA-CA parameters, see IEEE 802.15.4e-2012 */
 /* Min backoff exponent */
 #ifdef TSCH_CONF_MAC_MIN_BE
@@ -121,6 +162,9 @@ struct tsch_packet {
   uint8_t ret; /* status -- MAC return code */
   uint8_t header_len; /* length of header and header IEs (needed for link-layer security) */
   uint8_t tsch_sync_ie_offset; /* Offset within the frame used for quick update of EB ASN and join priority */
+#if TSCH_QUEUE_STATS
+  clock_time_t queued_at; /* when the packet was added to the queue */
+#endif /* TSCH_QUEUE_STATS */
 };
 
 /* TSCH neighbor information */
@@ -135,19 +179,48 @@ struct tsch_neighbor {
   uint8_t last_backoff_window; /* Last CSMA backoff window */
   uint8_t tx_links_count; /* How many links do we have to this neighbor? */
   uint8_t dedicated_tx_links_count; /* How many dedicated links do we have to this neighbor? */
-  /* Array for the ringbuf. Contains pointers to packets.
+  /* Array for the ringbuf of each class. Contains pointers to packets.
    * Its size must be a power of two to allow for atomic put */
-  struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
-  /* Circular buffer of pointers to packet. */
-  struct ringbufindex tx_ringbuf;
+  struct tsch_packet *tx_array[TSCH_QUEUE_CLASSES][TSCH_QUEUE_NUM_PER_NEIGHBOR];
+  /* Circular buffer of pointers to packet, for each class. */
+  struct ringbufindex tx_ringbuf[TSCH_QUEUE_CLASSES];
+#if TSCH_QUEUE_CLASSES > 1
+  /* Class of the packet last returned by tsch_queue_get_packet_for_nbr */
+  uint8_t tx_class;
+#ifdef TSCH_QUEUE_CLASS_WEIGHTS
+  /* Packets each class may still send in the current round */
+  uint8_t tx_credits[TSCH_QUEUE_CLASSES];
+#endif /* TSCH_QUEUE_CLASS_WEIGHTS */
+#endif /* TSCH_QUEUE_CLASSES > 1 */
+#if TSCH_QUEUE_READY_LIST
+  /* Next neighbor on the ready list and on the backoff list */
+  struct tsch_neighbor *next_ready;
+  struct tsch_neighbor *next_backoff;
+  uint8_t is_ready; /* is the neighbor on the ready list? */
+  uint8_t in_backoff; /* is the neighbor on the backoff list? */
+#endif /* TSCH_QUEUE_READY_LIST */
 };
 
+#if TSCH_QUEUE_STATS
+/* Per-class queue statistics */
+struct tsch_queue_stats {
+  unsigned long sent; /* packets removed from the queue after being sent */
+  unsigned long dropped; /* packets that were not queued, or removed unsent */
+  unsigned long latency; /* total time spent in the queue by removed packets, in clock ticks */
+  clock_time_t max_latency; /* longest time spent in the queue */
+};
+#endif /* TSCH_QUEUE_STATS */
+
 /***** External Variables *****/
 
 /* Broadcast and EB virtual neighbors */
 extern struct tsch_neighbor *n_broadcast;
 extern struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_STATS
+extern struct tsch_queue_stats tsch_queue_stats[TSCH_QUEUE_CLASSES];
+#endif /* TSCH_QUEUE_STATS */
+
 /********** Functions *********/
 
 /* Add a TSCH neighbor */
@@ -174,7 +247,7 @@ void tsch_queue_free_unused_neighbors(void);
 /* Is the neighbor queue empty? */
 int tsch_queue_is_empty(const struct tsch_neighbor *n);
 /* Returns the first packet from a neighbor queue */
-struct tsch_packet *tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *link);
+struct tsch_packet *tsch_queue_get_packet_for_nbr(struct tsch_neighbor *n, struct tsch_link *link);
 /* Returns the head packet from a neighbor queue (from neighbor address) */
 struct tsch_packet *tsch_queue_get_packet_for_dest_addr(const linkaddr_t *addr, struct tsch_link *link);
 /* Returns the head packet of any neighbor queue with zero backoff counter.
@@ -188,6 +261,9 @@ void tsch_queue_backoff_reset(struct tsch_neighbor *n);
 void tsch_queue_backoff_inc(struct tsch_neighbor *n);
 /* Decrement backoff window for all queues directed at dest_addr */
 void tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr);
+/* Recheck whether a neighbor may send over shared links, after changing
+ * its tx links. Call outside of slot operation. */
+void tsch_queue_update_nbr(struct tsch_neighbor *n);
 /* Initialize TSCH queue module */
 void tsch_queue_init(void);
 
@@ -69,6 +69,52 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_INDEX
+/* Returns the position in the index of the first link with a timeslot
+ * greater than the given one */
+static uint16_t
+index_search(const struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  uint16_t low = 0;
+  uint16_t high = sf->links_count;
+  while(low < high) {
+    uint16_t mid = (low + high) / 2;
+    if(sf->links_index[mid]->timeslot <= timeslot) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+/*---------------------------------------------------------------------------*/
+/* Adds a link to the index, after any link with the same timeslot */
+static void
+index_add(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t i = index_search(sf, l->timeslot);
+  memmove(&sf->links_index[i + 1], &sf->links_index[i],
+          (sf->links_count - i) * sizeof(sf->links_index[0]));
+  sf->links_index[i] = l;
+  sf->links_count++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t i = index_search(sf, l->timeslot);
+  while(i > 0) {
+    i--;
+    if(sf->links_index[i] == l) {
+      sf->links_count--;
+      memmove(&sf->links_index[i], &sf->links_index[i + 1],
+              (sf->links_count - i) * sizeof(sf->links_index[0]));
+      return;
+    }
+  }
+}
+#endif /* TSCH_SCHEDULE_INDEX */
+/*---------------------------------------------------------------------------*/
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -89,6 +135,9 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       TSCH_ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+#if TSCH_SCHEDULE_INDEX
+      sf->links_count = 0;
+#endif /* TSCH_SCHEDULE_INDEX */
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -209,6 +258,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+#if TSCH_SCHEDULE_INDEX
+        index_add(slotframe, l);
+#endif /* TSCH_SCHEDULE_INDEX */
 
         PRINTF("TSCH-schedule: add_link %u %u %u %u %u %u\n",
                slotframe->handle, link_options, link_type, timeslot, channel_offset, TSCH_LOG_ID_FROM_LINKADDR(address));
@@ -224,6 +276,7 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
             if(!(l->link_options & LINK_OPTION_SHARED)) {
               n->dedicated_tx_links_count++;
             }
+            tsch_queue_update_nbr(n);
           }
         }
       }
@@ -256,6 +309,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
              TSCH_LOG_ID_FROM_LINKADDR(&l->addr));
 
       list_remove(slotframe->links_list, l);
+#if TSCH_SCHEDULE_INDEX
+      index_remove(slotframe, l);
+#endif /* TSCH_SCHEDULE_INDEX */
       memb_free(&link_memb, l);
 
       /* Release the lock before we update the neighbor (will take the lock) */
@@ -269,6 +325,7 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
           if(!(link_options & LINK_OPTION_SHARED)) {
             n->dedicated_tx_links_count--;
           }
+          tsch_queue_update_nbr(n);
         }
       }
 
@@ -294,6 +351,17 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe, uint16_t ti
 {
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
+#if TSCH_SCHEDULE_INDEX
+      uint16_t i = index_search(slotframe, timeslot);
+      if(i > 0 && slotframe->links_index[i - 1]->timeslot == timeslot) {
+        /* Return the first link added at this timeslot, as the list would */
+        while(i > 1 && slotframe->links_index[i - 2]->timeslot == timeslot) {
+          i--;
+        }
+        return slotframe->links_index[i - 1];
+      }
+      return NULL;
+#else /* TSCH_SCHEDULE_INDEX */
       struct tsch_link *l = list_head(slotframe->links_list);
       /* Loop over all items. Assume there is max one link per timeslot */
       while(l != NULL) {
@@ -303,11 +371,58 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe, uint16_t ti
         l = list_item_next(l);
       }
       return l;
+#endif /* TSCH_SCHEDULE_INDEX */
     }
   }
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+/* Compares a link occurring in time_to_timeslot slots to the current best
+ * link, and updates the best link and its backup */
+static void
+select_link(struct tsch_link *l, uint16_t time_to_timeslot,
+            struct tsch_link **curr_best, uint16_t *time_to_curr_best,
+            struct tsch_link **curr_backup)
+{
+  if(*curr_best == NULL || time_to_timeslot < *time_to_curr_best) {
+    *time_to_curr_best = time_to_timeslot;
+    *curr_best = l;
+    *curr_backup = NULL;
+  } else if(time_to_timeslot == *time_to_curr_best) {
+    struct tsch_link *new_best = NULL;
+    /* Two links are overlapping, we need to select one of them.
+     * By standard: prioritize Tx links first, second by lowest handle */
+    if(((*curr_best)->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+      /* Both or neither links have Tx, select the one with lowest handle */
+      if(l->slotframe_handle < (*curr_best)->slotframe_handle) {
+        new_best = l;
+      }
+    } else {
+      /* Select the link that has the Tx option */
+      if(l->link_options & LINK_OPTION_TX) {
+        new_best = l;
+      }
+    }
+
+    /* Maintain backup_link */
+    if(*curr_backup == NULL) {
+      /* Check if 'l' best can be used as backup */
+      if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+        *curr_backup = l;
+      }
+      /* Check if curr_best can be used as backup */
+      if(new_best != *curr_best && ((*curr_best)->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+        *curr_backup = *curr_best;
+      }
+    }
+
+    /* Maintain curr_best */
+    if(new_best != NULL) {
+      *curr_best = new_best;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
 tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset,
@@ -325,52 +440,39 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_INDEX
+      /* Only the links at the first timeslot after the current one can
+       * be the earliest of this slotframe, wrapping around if needed */
+      if(sf->links_count > 0) {
+        uint16_t i = index_search(sf, timeslot);
+        uint16_t next_timeslot;
+        uint16_t time_to_timeslot;
+        if(i == sf->links_count) {
+          i = 0;
+        }
+        next_timeslot = sf->links_index[i]->timeslot;
+        time_to_timeslot =
+          next_timeslot > timeslot ?
+          next_timeslot - timeslot :
+          sf->size.val + next_timeslot - timeslot;
+        while(i < sf->links_count && sf->links_index[i]->timeslot == next_timeslot) {
+          select_link(sf->links_index[i], time_to_timeslot,
+                      &curr_best, &time_to_curr_best, &curr_backup);
+          i++;
+        }
+      }
+#else /* TSCH_SCHEDULE_INDEX */
       struct tsch_link *l = list_head(sf->links_list);
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
           l->timeslot - timeslot :
           sf->size.val + l->timeslot - timeslot;
-        if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
-          time_to_curr_best = time_to_timeslot;
-          curr_best = l;
-          curr_backup = NULL;
-        } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle < curr_best->slotframe_handle) {
-              new_best = l;
-            }
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-          /* Maintain backup_link */
-          if(curr_backup == NULL) {
-            /* Check if 'l' best can be used as backup */
-            if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-              curr_backup = l;
-            }
-            /* Check if curr_best can be used as backup */
-            if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-              curr_backup = curr_best;
-            }
-          }
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
-        }
-
+        select_link(l, time_to_timeslot,
+                    &curr_best, &time_to_curr_best, &curr_backup);
         l = list_item_next(l);
       }
+#endif /* TSCH_SCHEDULE_INDEX */
       sf = list_item_next(sf);
     }
     if(time_offset != NULL) {
@@ -72,6 +72,15 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep the links of each slotframe sorted by timeslot, so that the next
+ * active link is found by binary search rather than by going through every
+ * link. Costs TSCH_SCHEDULE_MAX_LINKS pointers per slotframe. */
+#ifdef TSCH_SCHEDULE_CONF_INDEX
+#define TSCH_SCHEDULE_INDEX TSCH_SCHEDULE_CONF_INDEX
+#else
+#define TSCH_SCHEDULE_INDEX 0
+#endif
+
 /********** Constants *********/
 
 /* Link options */
@@ -122,6 +131,11 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_SCHEDULE_INDEX
+  /* Links belonging to this slotframe, sorted by timeslot */
+  struct tsch_link *links_index[TSCH_SCHEDULE_MAX_LINKS];
+  uint16_t links_count;
+#endif /* TSCH_SCHEDULE_INDEX */
 };
 
 /********** Functions *********/
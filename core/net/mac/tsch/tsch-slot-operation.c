@@ -301,7 +301,9 @@ tsch_schedule_slot_operation(struct rtimer *tm, rtimer_clock_t ref_time, rtimer_
     return 0;
   }
   ref_time += offset;
-  r = rtimer_set(tm, ref_time, 1, (void (*)(struct rtimer *, void *))tsch_slot_operation, NULL);
+  r = rtimer_set_with_priority(tm, ref_time,
+                               (void (*)(struct rtimer *, void *))tsch_slot_operation,
+                               NULL, RTIMER_PRIORITY_MAC);
   if(r != RTIMER_OK) {
     return 0;
   }
@@ -242,6 +242,10 @@ keepalive_send()
     /* Simply send an empty packet */
     packetbuf_clear();
     packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &n->addr);
+#if TSCH_QUEUE_CLASSES > 1
+    /* Keep synchronized even when the queue is busy */
+    packetbuf_set_attr(PACKETBUF_ATTR_TSCH_CLASS, TSCH_QUEUE_CLASSES - 1);
+#endif /* TSCH_QUEUE_CLASSES > 1 */
     NETSTACK_LLSEC.send(keepalive_packet_sent, NULL);
     PRINTF("TSCH: sending KA to %u\n",
            TSCH_LOG_ID_FROM_LINKADDR(&n->addr));
@@ -38,6 +38,7 @@
 #include <string.h>
 #include "lib/memb.h"
 #include "lib/list.h"
+#include "lib/hashindex.h"
 #include "net/nbr-table.h"
 
 #define DEBUG 0
@@ -126,16 +127,38 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_HASH
+/* Get the link-layer address of a neighbor index */
+static const void *
+lladdr_from_index(uint16_t index)
+{
+  return &key_from_index(index)->lladdr;
+}
+/* Hash index over the link-layer addresses of the keys on the list */
+HASHINDEX(lladdr_index, NBR_TABLE_MAX_NEIGHBORS, LINKADDR_SIZE,
+          lladdr_from_index);
+#define hash_insert(key) hashindex_add(&lladdr_index, index_from_key(key))
+#define hash_remove(key) hashindex_remove(&lladdr_index, index_from_key(key))
+#else /* NBR_TABLE_HASH */
+#define hash_insert(key)
+#define hash_remove(key)
+#endif /* NBR_TABLE_HASH */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if !NBR_TABLE_HASH
   nbr_table_key_t *key;
+#endif /* !NBR_TABLE_HASH */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_HASH
+  return hashindex_lookup(&lladdr_index, lladdr);
+#else /* NBR_TABLE_HASH */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -144,6 +167,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     key = list_item_next(key);
   }
   return -1;
+#endif /* NBR_TABLE_HASH */
 }
 /*---------------------------------------------------------------------------*/
 /* Get bit from "used" or "locked" bitmap */
@@ -195,6 +219,7 @@ remove_key(nbr_table_key_t *least_used_key)
   used_map[index_from_key(least_used_key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, least_used_key);
+  hash_remove(least_used_key);
 }
 /*---------------------------------------------------------------------------*/
 static nbr_table_key_t *
@@ -359,6 +384,7 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+    hash_insert(key);
   }
 
   /* Get item in the current table */
@@ -450,7 +476,9 @@ nbr_table_update_lladdr(const linkaddr_t *old_addr, const linkaddr_t *new_addr,
    * Copy the new lladdr into the key - since we know that there is no
    * conflicting entry.
    */
+  hash_remove(key);
   memcpy(&key->lladdr, new_addr, sizeof(linkaddr_t));
+  hash_insert(key);
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -46,6 +46,15 @@
 #define NBR_TABLE_MAX_NEIGHBORS 8
 #endif /* NBR_TABLE_CONF_MAX_NEIGHBORS */
 
+/* Look neighbors up by link-layer address through an open-addressed
+   hash index instead of walking the list of neighbors. Costs two
+   bytes per neighbor slot, four with more than 255 neighbors. */
+#ifdef NBR_TABLE_CONF_HASH
+#define NBR_TABLE_HASH NBR_TABLE_CONF_HASH
+#else /* NBR_TABLE_CONF_HASH */
+#define NBR_TABLE_HASH 0
+#endif /* NBR_TABLE_CONF_HASH */
+
 /* An item in a neighbor table */
 typedef void nbr_table_item_t;
 
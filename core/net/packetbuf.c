@@ -48,6 +48,7 @@
 #include "net/packetbuf.h"
 #include "net/rime/rime.h"
 #include "sys/cc.h"
+#include "lib/assert.h"
 
 struct packetbuf_attr packetbuf_attrs[PACKETBUF_NUM_ATTRS];
 struct packetbuf_addr packetbuf_addrs[PACKETBUF_NUM_ADDRS];
@@ -60,8 +61,18 @@ static uint8_t hdrlen;
    an even 32-bit boundary. On some platforms (most notably the
    msp430 or OpenRISC), having a potentially misaligned packet buffer may lead to
    problems when accessing words. */
+#if PACKETBUF_POOL_SIZE
+/* The first buffer of the pool starts out as the current one, so
+   that the packetbuf needs no initialization. A buffer is free when
+   its reference count is zero. */
+static struct packetbuf_buffer pool[PACKETBUF_POOL_SIZE] = { { 1 } };
+static struct packetbuf_buffer *current = &pool[0];
+static uint8_t *packetbuf = pool[0].data.u8;
+static uint8_t numfree = PACKETBUF_POOL_SIZE - 1;
+#else /* PACKETBUF_POOL_SIZE */
 static uint32_t packetbuf_aligned[(PACKETBUF_SIZE + 3) / 4];
 static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
+#endif /* PACKETBUF_POOL_SIZE */
 
 #define DEBUG 0
 #if DEBUG
@@ -71,10 +82,109 @@ static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
 #define PRINTF(...)
 #endif
 
+#if PACKETBUF_POOL_SIZE
+/*---------------------------------------------------------------------------*/
+static struct packetbuf_buffer *
+alloc_buffer(void)
+{
+  int i;
+
+  for(i = 0; i < PACKETBUF_POOL_SIZE; i++) {
+    if(pool[i].refcount == 0) {
+      pool[i].refcount = 1;
+      numfree--;
+      return &pool[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Move the packetbuf to a buffer of its own before writing to it, if
+   the current buffer is held elsewhere. packetbuf_hold() keeps a free
+   buffer around for this whenever the current buffer is shared, so
+   this only fails if that reserve has been broken. */
+static int
+unshare(int copy)
+{
+  struct packetbuf_buffer *b;
+
+  if(current->refcount <= 1) {
+    return 1;
+  }
+  b = alloc_buffer();
+  assert(b != NULL);
+  if(b == NULL) {
+    PRINTF("packetbuf: no free buffer to unshare\n");
+    return 0;
+  }
+  if(copy) {
+    memcpy(b->data.u8, packetbuf, MIN(packetbuf_totlen(), PACKETBUF_SIZE));
+  }
+  current->refcount--;
+  current = b;
+  packetbuf = b->data.u8;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+struct packetbuf_buffer *
+packetbuf_hold(uint16_t *len)
+{
+  struct packetbuf_buffer *b;
+
+  if(bufptr == 0) {
+    /* The packet is consecutive from the start of the buffer */
+    if(current->refcount == 1 && numfree == 0) {
+      return NULL;
+    }
+    current->refcount++;
+    *len = hdrlen + buflen;
+    return current;
+  }
+
+  /* The header has been reduced, store a compacted copy */
+  if(numfree < (current->refcount > 1 ? 2 : 1)) {
+    return NULL;
+  }
+  b = alloc_buffer();
+  *len = packetbuf_copyto(b->data.u8);
+  return b;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_release(struct packetbuf_buffer *b)
+{
+  if(b != NULL && b->refcount > 0) {
+    if(--b->refcount == 0) {
+      numfree++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_restore(struct packetbuf_buffer *b, uint16_t len)
+{
+  b->refcount++;
+  packetbuf_release(current);
+  current = b;
+  packetbuf = b->data.u8;
+  buflen = MIN(PACKETBUF_SIZE, len);
+  bufptr = hdrlen = 0;
+}
+#else /* PACKETBUF_POOL_SIZE */
+/*---------------------------------------------------------------------------*/
+static int
+unshare(int copy)
+{
+  return 1;
+}
+#endif /* PACKETBUF_POOL_SIZE */
 /*---------------------------------------------------------------------------*/
 void
 packetbuf_clear(void)
 {
+  /* On failure, the data of the shared buffer is left as it is and
+     packetbuf_copyfrom() and packetbuf_hdralloc() refuse to write */
+  unshare(0);
   buflen = bufptr = 0;
   hdrlen = 0;
 
@@ -87,6 +197,9 @@ packetbuf_copyfrom(const void *from, uint16_t len)
   uint16_t l;
 
   packetbuf_clear();
+  if(!unshare(0)) {
+    return 0;
+  }
   l = MIN(PACKETBUF_SIZE, len);
   memcpy(packetbuf, from, l);
   buflen = l;
@@ -99,6 +212,7 @@ packetbuf_compact(void)
   int16_t i;
 
   if(bufptr) {
+    unshare(1);
     /* shift data to the left */
     for(i = 0; i < buflen; i++) {
       packetbuf[hdrlen + i] = packetbuf[packetbuf_hdrlen() + i];
@@ -113,24 +227,23 @@ packetbuf_copyto(void *to)
   if(hdrlen + buflen > PACKETBUF_SIZE) {
     return 0;
   }
-  memcpy(to, packetbuf_hdrptr(), hdrlen);
-  memcpy((uint8_t *)to + hdrlen, packetbuf_dataptr(), buflen);
+  memcpy(to, packetbuf, hdrlen);
+  memcpy((uint8_t *)to + hdrlen, packetbuf + packetbuf_hdrlen(), buflen);
   return hdrlen + buflen;
 }
 /*---------------------------------------------------------------------------*/
 int
 packetbuf_hdralloc(int size)
 {
-  int16_t i;
-
   if(size + packetbuf_totlen() > PACKETBUF_SIZE) {
     return 0;
   }
 
-  /* shift data to the right */
-  for(i = packetbuf_totlen() - 1; i >= 0; i--) {
-    packetbuf[i + size] = packetbuf[i];
+  if(!unshare(1)) {
+    return 0;
   }
+  /* shift data to the right */
+  memmove(packetbuf + size, packetbuf, packetbuf_totlen());
   hdrlen += size;
   return 1;
 }
@@ -157,11 +270,25 @@ packetbuf_set_datalen(uint16_t len)
 void *
 packetbuf_dataptr(void)
 {
+  unshare(1);
   return packetbuf + packetbuf_hdrlen();
 }
 /*---------------------------------------------------------------------------*/
 void *
 packetbuf_hdrptr(void)
+{
+  unshare(1);
+  return packetbuf;
+}
+/*---------------------------------------------------------------------------*/
+const void *
+packetbuf_const_dataptr(void)
+{
+  return packetbuf + packetbuf_hdrlen();
+}
+/*---------------------------------------------------------------------------*/
+const void *
+packetbuf_const_hdrptr(void)
 {
   return packetbuf;
 }
@@ -72,6 +72,16 @@
 #define PACKETBUF_WITH_PACKET_TYPE NETSTACK_CONF_WITH_RIME
 #endif
 
+/* Number of buffers in the packet buffer pool. With a pool, the
+   packetbuf operates on a current buffer taken from the pool, and
+   queued packets keep a reference to the buffer holding them instead
+   of a copy. Zero keeps a single static packetbuf. */
+#ifdef PACKETBUF_CONF_POOL_SIZE
+#define PACKETBUF_POOL_SIZE PACKETBUF_CONF_POOL_SIZE
+#else
+#define PACKETBUF_POOL_SIZE 0
+#endif
+
 /**
  * \brief      Clear and reset the packetbuf
  *
@@ -101,6 +111,27 @@ void *packetbuf_dataptr(void);
  */
 void *packetbuf_hdrptr(void);
 
+/**
+ * \brief      Get a read-only pointer to the data in the packetbuf
+ * \return     Pointer to the packetbuf data
+ *
+ *             Unlike packetbuf_dataptr(), this function never moves
+ *             the packetbuf to a buffer of its own, so reading a
+ *             packet restored from a queuebuf does not copy it.
+ *
+ */
+const void *packetbuf_const_dataptr(void);
+
+/**
+ * \brief      Get a read-only pointer to the header in the packetbuf
+ * \return     Pointer to the packetbuf header
+ *
+ *             The read-only counterpart of packetbuf_hdrptr(), for
+ *             handing a frame to the radio.
+ *
+ */
+const void *packetbuf_const_hdrptr(void);
+
 /**
  * \brief      Get the length of the header in the packetbuf
  * \return     Length of the header in the packetbuf
@@ -211,6 +242,61 @@ int packetbuf_hdralloc(int size);
  */
 int packetbuf_hdrreduce(int size);
 
+#if PACKETBUF_POOL_SIZE
+/**
+ * \brief      A buffer from the packet buffer pool
+ */
+struct packetbuf_buffer {
+  uint8_t refcount;
+  union {
+    uint32_t u32[(PACKETBUF_SIZE + 3) / 4];
+    uint8_t u8[PACKETBUF_SIZE];
+  } data;
+};
+
+/**
+ * \brief      Take a reference to the packet in the packetbuf
+ * \param len  Filled in with the length of the packet
+ * \return     The buffer holding the packet, or NULL if the pool is exhausted
+ *
+ *             This function returns a pool buffer that holds the
+ *             header and data of the current packet, consecutive from
+ *             the start of the buffer. The packet is not copied unless
+ *             its header has been reduced. The packetbuf can still be
+ *             used afterwards: it moves to a buffer of its own before
+ *             the held packet could be modified.
+ *
+ *             The reference must be dropped with packetbuf_release().
+ *
+ *             Whenever the current buffer is shared, at least one
+ *             pool buffer is kept free, so that the packetbuf can
+ *             always move before it is written to. This function
+ *             returns NULL rather than use up that reserve, which
+ *             is why the pool needs at least two buffers.
+ *
+ */
+struct packetbuf_buffer *packetbuf_hold(uint16_t *len);
+
+/**
+ * \brief      Drop a reference taken with packetbuf_hold()
+ * \param b    The buffer
+ */
+void packetbuf_release(struct packetbuf_buffer *b);
+
+/**
+ * \brief      Make a held buffer the current packetbuf
+ * \param b    The buffer, from packetbuf_hold()
+ * \param len  The length of the packet in the buffer
+ *
+ *             This function works like packetbuf_copyfrom(), but
+ *             switches the packetbuf to the buffer instead of copying
+ *             it. The caller keeps its own reference to the
+ *             buffer. Packet attributes are left untouched.
+ *
+ */
+void packetbuf_restore(struct packetbuf_buffer *b, uint16_t len);
+#endif /* PACKETBUF_POOL_SIZE */
+
 /* Packet attributes stuff below: */
 
 typedef uint16_t packetbuf_attr_t;
@@ -248,6 +334,9 @@ enum {
   PACKETBUF_ATTR_TSCH_SLOTFRAME,
   PACKETBUF_ATTR_TSCH_TIMESLOT,
 #endif /* TSCH_WITH_LINK_SELECTOR */
+#if TSCH_QUEUE_CLASSES > 1
+  PACKETBUF_ATTR_TSCH_CLASS,
+#endif /* TSCH_QUEUE_CLASSES > 1 */
 
   /* Scope 1 attributes: used between two neighbors only. */
 #if PACKETBUF_WITH_PACKET_TYPE
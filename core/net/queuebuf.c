@@ -50,6 +50,10 @@
 
 #include <string.h> /* for memcpy() */
 
+#if WITH_SWAP && PACKETBUF_POOL_SIZE
+#error "Swapping queuebufs is not supported with a packet buffer pool"
+#endif
+
 /* Structure pointing to a buffer either stored
    in RAM or swapped in CFS */
 struct queuebuf {
@@ -70,9 +74,14 @@ struct queuebuf {
 #endif
 };
 
-/* The actual queuebuf data */
+/* The actual queuebuf data. With a packet buffer pool, the packet
+   stays in the pool buffer it was built in. */
 struct queuebuf_data {
+#if PACKETBUF_POOL_SIZE
+  struct packetbuf_buffer *buf;
+#else /* PACKETBUF_POOL_SIZE */
   uint8_t data[PACKETBUF_SIZE];
+#endif /* PACKETBUF_POOL_SIZE */
   uint16_t len;
   struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
@@ -339,7 +348,17 @@ queuebuf_new_from_packetbuf(void)
     buframptr = buf->ram_ptr;
 #endif
 
+#if PACKETBUF_POOL_SIZE
+    buframptr->buf = packetbuf_hold(&buframptr->len);
+    if(buframptr->buf == NULL) {
+      PRINTF("queuebuf_new_from_packetbuf: could not hold the packetbuf\n");
+      memb_free(&buframmem, buframptr);
+      memb_free(&bufmem, buf);
+      return NULL;
+    }
+#else /* PACKETBUF_POOL_SIZE */
     buframptr->len = packetbuf_copyto(buframptr->data);
+#endif /* PACKETBUF_POOL_SIZE */
     packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
 
 #if WITH_SWAP
@@ -383,7 +402,21 @@ queuebuf_update_from_packetbuf(struct queuebuf *buf)
 {
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
   packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+#if PACKETBUF_POOL_SIZE
+  {
+    uint16_t len;
+    struct packetbuf_buffer *b = packetbuf_hold(&len);
+    if(b == NULL) {
+      PRINTF("queuebuf_update_from_packetbuf: could not hold the packetbuf\n");
+      return;
+    }
+    packetbuf_release(buframptr->buf);
+    buframptr->buf = b;
+    buframptr->len = len;
+  }
+#else /* PACKETBUF_POOL_SIZE */
   buframptr->len = packetbuf_copyto(buframptr->data);
+#endif /* PACKETBUF_POOL_SIZE */
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
     queuebuf_flush_tmpdata();
@@ -402,6 +435,9 @@ queuebuf_free(struct queuebuf *buf)
       queuebuf_remove_from_file(buf->swap_id);
     }
 #else
+#if PACKETBUF_POOL_SIZE
+    packetbuf_release(buf->ram_ptr->buf);
+#endif /* PACKETBUF_POOL_SIZE */
     memb_free(&buframmem, buf->ram_ptr);
 #endif
     memb_free(&bufmem, buf);
@@ -420,7 +456,11 @@ queuebuf_to_packetbuf(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if PACKETBUF_POOL_SIZE
+    packetbuf_restore(buframptr->buf, buframptr->len);
+#else /* PACKETBUF_POOL_SIZE */
     packetbuf_copyfrom(buframptr->data, buframptr->len);
+#endif /* PACKETBUF_POOL_SIZE */
     packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
   }
 }
@@ -430,7 +470,11 @@ queuebuf_dataptr(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if PACKETBUF_POOL_SIZE
+    return buframptr->buf->data.u8;
+#else /* PACKETBUF_POOL_SIZE */
     return buframptr->data;
+#endif /* PACKETBUF_POOL_SIZE */
   }
   return NULL;
 }
@@ -457,6 +501,18 @@ queuebuf_attr(struct queuebuf *b, uint8_t type)
 }
 /*---------------------------------------------------------------------------*/
 void
+queuebuf_set_attr(struct queuebuf *b, uint8_t type, packetbuf_attr_t val)
+{
+  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+  buframptr->attrs[type].val = val;
+#if WITH_SWAP
+  if(b->location == IN_CFS) {
+    queuebuf_flush_tmpdata();
+  }
+#endif
+}
+/*---------------------------------------------------------------------------*/
+void
 queuebuf_debug_print(void)
 {
 #if QUEUEBUF_DEBUG
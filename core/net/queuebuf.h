@@ -106,6 +106,18 @@ int queuebuf_datalen(struct queuebuf *b);
 
 linkaddr_t *queuebuf_addr(struct queuebuf *b, uint8_t type);
 packetbuf_attr_t queuebuf_attr(struct queuebuf *b, uint8_t type);
+/**
+ * \brief      Set an attribute of a queued packet
+ * \param b    The queuebuf
+ * \param type The attribute
+ * \param val  The new value of the attribute
+ *
+ *             Unlike queuebuf_update_attr_from_packetbuf(), this
+ *             leaves the packetbuf alone, so it is cheap enough to
+ *             mark a packet that is already queued.
+ *
+ */
+void queuebuf_set_attr(struct queuebuf *b, uint8_t type, packetbuf_attr_t val);
 
 void queuebuf_debug_print(void);
 
@@ -322,11 +322,41 @@ count_matching_bytes(const void *p1, const void *p2, size_t n)
   return n;
 }
 /*---------------------------------------------------------------------------*/
+#if RPL_NS_SRH_CACHE
+/* A source routing header as built for a destination, valid as long
+   as no link on the path to the destination changed since */
+struct srh_cache_entry {
+  const rpl_ns_node_t *node;
+  uint32_t generation;
+  uip_ipaddr_t next_hop;
+  uint8_t ext_len;
+  uint8_t header[RPL_NS_SRH_CACHE_LEN];
+};
+static struct srh_cache_entry srh_cache[RPL_NS_SRH_CACHE];
+#endif /* RPL_NS_SRH_CACHE */
+/*---------------------------------------------------------------------------*/
+/* Account for an extension header of ext_len bytes, inserted right
+   after the IPv6 header */
+static void
+add_ext_len(uint8_t ext_len)
+{
+  uint8_t temp_len;
+
+  /* In-place update of IPv6 length field */
+  temp_len = UIP_IP_BUF->len[1];
+  UIP_IP_BUF->len[1] += ext_len;
+  if(UIP_IP_BUF->len[1] < temp_len) {
+    UIP_IP_BUF->len[0]++;
+  }
+
+  uip_ext_len += ext_len;
+  uip_len += ext_len;
+}
+/*---------------------------------------------------------------------------*/
 static int
 insert_srh_header(void)
 {
   /* Implementation of RFC6554 */
-  uint8_t temp_len;
   uint8_t path_len;
   uint8_t ext_len;
   uint8_t cmpri, cmpre; /* ComprI and ComprE fields of the RPL Source Routing Header */
@@ -337,6 +367,9 @@ insert_srh_header(void)
   rpl_ns_node_t *node;
   rpl_dag_t *dag;
   uip_ipaddr_t node_addr;
+#if RPL_NS_SRH_CACHE
+  struct srh_cache_entry *entry;
+#endif /* RPL_NS_SRH_CACHE */
 
   PRINTF("RPL: SRH creating source routing header with destination ");
   PRINT6ADDR(&UIP_IP_BUF->destipaddr);
@@ -358,6 +391,31 @@ insert_srh_header(void)
     return 1;
   }
 
+#if RPL_NS_SRH_CACHE
+  entry = &srh_cache[((uintptr_t)dest_node / sizeof(rpl_ns_node_t)) %
+                     RPL_NS_SRH_CACHE];
+  if(entry->node == dest_node &&
+     rpl_ns_is_path_unchanged(dest_node, entry->generation)) {
+    ext_len = entry->ext_len;
+    if(ext_len == 0) {
+      /* The destination is a child of the root */
+      return 1;
+    }
+    if(uip_len + ext_len > UIP_BUFSIZE) {
+      PRINTF("RPL: Packet too long: impossible to add source routing header (%u bytes)\n", ext_len);
+      return 1;
+    }
+    memmove(uip_buf + uip_l2_l3_hdr_len + ext_len,
+        uip_buf + uip_l2_l3_hdr_len, uip_len - UIP_IPH_LEN);
+    memcpy(uip_buf + uip_l2_l3_hdr_len, entry->header, ext_len);
+    UIP_RH_BUF->next = UIP_IP_BUF->proto;
+    UIP_IP_BUF->proto = UIP_PROTO_ROUTING;
+    uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &entry->next_hop);
+    add_ext_len(ext_len);
+    return 1;
+  }
+#endif /* RPL_NS_SRH_CACHE */
+
   root_node = rpl_ns_get_node(dag, &dag->dag_id);
   if(root_node == NULL) {
     PRINTF("RPL: SRH root node not found\n");
@@ -378,6 +436,11 @@ insert_srh_header(void)
 
   if(node == root_node) {
     PRINTF("RPL: SRH no need to insert SRH\n");
+#if RPL_NS_SRH_CACHE
+    entry->node = dest_node;
+    entry->generation = rpl_ns_generation();
+    entry->ext_len = 0;
+#endif /* RPL_NS_SRH_CACHE */
     return 1;
   }
 
@@ -449,15 +512,17 @@ insert_srh_header(void)
   rpl_ns_get_node_global_addr(&node_addr, node);
   uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
 
-  /* In-place update of IPv6 length field */
-  temp_len = UIP_IP_BUF->len[1];
-  UIP_IP_BUF->len[1] += ext_len;
-  if(UIP_IP_BUF->len[1] < temp_len) {
-    UIP_IP_BUF->len[0]++;
+#if RPL_NS_SRH_CACHE
+  if(ext_len <= RPL_NS_SRH_CACHE_LEN) {
+    entry->node = dest_node;
+    entry->generation = rpl_ns_generation();
+    uip_ipaddr_copy(&entry->next_hop, &node_addr);
+    entry->ext_len = ext_len;
+    memcpy(entry->header, UIP_RH_BUF, ext_len);
   }
+#endif /* RPL_NS_SRH_CACHE */
 
-  uip_ext_len += ext_len;
-  uip_len += ext_len;
+  add_ext_len(ext_len);
 
   return 1;
 }
@@ -47,6 +47,7 @@
 #include "net/rpl/rpl-ns.h"
 #include "lib/list.h"
 #include "lib/memb.h"
+#include "lib/hashindex.h"
 
 #if RPL_WITH_NON_STORING
 
@@ -63,6 +64,34 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, rpl_ns_node_t, RPL_NS_LINK_NUM);
 
+/* Increases whenever the link of a node changes */
+static uint32_t generation;
+
+#if RPL_NS_SRH_CACHE
+/* Stamp a node whose link changed, so that cached paths through it
+   are no longer used */
+#define LINK_CHANGED(n) ((n)->generation = ++generation)
+#else /* RPL_NS_SRH_CACHE */
+#define LINK_CHANGED(n) (++generation)
+#endif /* RPL_NS_SRH_CACHE */
+
+#if RPL_NS_HASH
+#define NODE_FROM_INDEX(i) (&((rpl_ns_node_t *)nodememb.mem)[i])
+#define INDEX_FROM_NODE(n) ((n) - (rpl_ns_node_t *)nodememb.mem)
+
+/* Get the link identifier of a node index */
+static const void *
+link_identifier_from_index(uint16_t index)
+{
+  return NODE_FROM_INDEX(index)->link_identifier;
+}
+/* Hash index over the link identifiers of the nodes. Nodes of different
+ * DAGs may share a link identifier, so lookups walk all entries that
+ * hash alike. */
+HASHINDEX(link_identifier_index, RPL_NS_LINK_NUM, 8,
+          link_identifier_from_index);
+#endif /* RPL_NS_HASH */
+
 /*---------------------------------------------------------------------------*/
 int
 rpl_ns_num_nodes(void)
@@ -84,6 +113,23 @@ node_matches_address(const rpl_dag_t *dag, const rpl_ns_node_t *node, const uip_
 rpl_ns_node_t *
 rpl_ns_get_node(const rpl_dag_t *dag, const uip_ipaddr_t *addr)
 {
+#if RPL_NS_HASH
+  uint16_t slot;
+  int index;
+
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(slot = hashindex_home(&link_identifier_index,
+                            ((const unsigned char *)addr) + 8);
+      (index = hashindex_get(&link_identifier_index, slot)) >= 0;
+      slot = hashindex_next(&link_identifier_index, slot)) {
+    if(node_matches_address(dag, NODE_FROM_INDEX(index), addr)) {
+      return NODE_FROM_INDEX(index);
+    }
+  }
+  return NULL;
+#else /* RPL_NS_HASH */
   rpl_ns_node_t *l;
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
     /* Compare prefix and node identifier */
@@ -92,6 +138,7 @@ rpl_ns_get_node(const rpl_dag_t *dag, const uip_ipaddr_t *addr)
     }
   }
   return NULL;
+#endif /* RPL_NS_HASH */
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -114,6 +161,7 @@ rpl_ns_expire_parent(rpl_dag_t *dag, const uip_ipaddr_t *child, const uip_ipaddr
   /* Check if parent matches */
   if(l != NULL && node_matches_address(dag, l->parent, parent)) {
     l->lifetime = RPL_NOPATH_REMOVAL_DELAY;
+    LINK_CHANGED(l);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -142,18 +190,25 @@ rpl_ns_update_node(rpl_dag_t *dag, const uip_ipaddr_t *child, const uip_ipaddr_t
       return NULL;
     }
     child_node->parent = NULL;
+    child_node->dag = NULL;
     list_add(nodelist, child_node);
     num_nodes++;
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+#if RPL_NS_HASH
+    hashindex_add(&link_identifier_index, INDEX_FROM_NODE(child_node));
+#endif /* RPL_NS_HASH */
   }
 
   /* Initialize node */
-  child_node->dag = dag;
+  if(child_node->dag != dag) {
+    child_node->dag = dag;
+    LINK_CHANGED(child_node);
+  }
   child_node->lifetime = lifetime;
-  memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+  old_parent_node = child_node->parent;
 
   /* Is the node reachable before the update? */
   if(rpl_ns_is_node_reachable(dag, child)) {
-    old_parent_node = child_node->parent;
     /* Update node */
     child_node->parent = parent_node;
     /* Has the node become unreachable? May happen if we create a loop. */
@@ -166,6 +221,9 @@ rpl_ns_update_node(rpl_dag_t *dag, const uip_ipaddr_t *child, const uip_ipaddr_t
   } else {
     child_node->parent = parent_node;
   }
+  if(child_node->parent != old_parent_node) {
+    LINK_CHANGED(child_node);
+  }
 
   return child_node;
 }
@@ -176,6 +234,10 @@ rpl_ns_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if RPL_NS_HASH
+  hashindex_init(&link_identifier_index);
+#endif /* RPL_NS_HASH */
+  generation++;
 }
 /*---------------------------------------------------------------------------*/
 rpl_ns_node_t *
@@ -202,7 +264,7 @@ rpl_ns_get_node_global_addr(uip_ipaddr_t *addr, rpl_ns_node_t *node)
 void
 rpl_ns_periodic(void)
 {
-  rpl_ns_node_t *l;
+  rpl_ns_node_t *l, *next;
   /* First pass, decrement lifetime for all nodes with non-infinite lifetime */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
     /* Don't touch infinite lifetime nodes */
@@ -211,7 +273,8 @@ rpl_ns_periodic(void)
     }
   }
   /* Second pass, for all expire nodes, deallocate them iff no child points to them */
-  for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
+  for(l = list_head(nodelist); l != NULL; l = next) {
+    next = list_item_next(l);
     if(l->lifetime == 0) {
       rpl_ns_node_t *l2;
       for(l2 = list_head(nodelist); l2 != NULL; l2 = list_item_next(l2)) {
@@ -219,12 +282,41 @@ rpl_ns_periodic(void)
           break;
         }
       }
-      /* No child found, deallocate node */
-      list_remove(nodelist, l);
-      memb_free(&nodememb, l);
-      num_nodes--;
+      if(l2 == NULL) {
+        /* No child found, deallocate node */
+#if RPL_NS_HASH
+        hashindex_remove(&link_identifier_index, INDEX_FROM_NODE(l));
+#endif /* RPL_NS_HASH */
+        list_remove(nodelist, l);
+        memb_free(&nodememb, l);
+        num_nodes--;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+rpl_ns_generation(void)
+{
+  return generation;
+}
+/*---------------------------------------------------------------------------*/
+#if RPL_NS_SRH_CACHE
+int
+rpl_ns_is_path_unchanged(const rpl_ns_node_t *node, uint32_t since)
+{
+  int max_depth = RPL_NS_LINK_NUM;
+  /* A node is only removed once no child points to it, so the nodes of
+     a path are still allocated as long as none of their links changed */
+  while(node != NULL && max_depth > 0) {
+    if(node->generation > since) {
+      return 0;
     }
+    node = node->parent;
+    max_depth--;
   }
+  return node == NULL;
 }
+#endif /* RPL_NS_SRH_CACHE */
 
 #endif /* RPL_WITH_NON_STORING */
@@ -49,6 +49,29 @@
 #define RPL_NS_LINK_NUM 32
 #endif /* RPL_NS_CONF_LINK_NUM */
 
+/* Look nodes up by address through an open-addressed hash index
+   instead of walking the list of nodes */
+#ifdef RPL_NS_CONF_HASH
+#define RPL_NS_HASH RPL_NS_CONF_HASH
+#else /* RPL_NS_CONF_HASH */
+#define RPL_NS_HASH 0
+#endif /* RPL_NS_CONF_HASH */
+
+/* Number of source routing headers the root keeps ready for use by
+   later packets to the same destination, 0 to build every header */
+#ifdef RPL_NS_CONF_SRH_CACHE
+#define RPL_NS_SRH_CACHE RPL_NS_CONF_SRH_CACHE
+#else /* RPL_NS_CONF_SRH_CACHE */
+#define RPL_NS_SRH_CACHE 0
+#endif /* RPL_NS_CONF_SRH_CACHE */
+
+/* Longest source routing header that is cached, in bytes */
+#ifdef RPL_NS_CONF_SRH_CACHE_LEN
+#define RPL_NS_SRH_CACHE_LEN RPL_NS_CONF_SRH_CACHE_LEN
+#else /* RPL_NS_CONF_SRH_CACHE_LEN */
+#define RPL_NS_SRH_CACHE_LEN 64
+#endif /* RPL_NS_CONF_SRH_CACHE_LEN */
+
 typedef struct rpl_ns_node {
   struct rpl_ns_node *next;
   uint32_t lifetime;
@@ -56,6 +79,10 @@ typedef struct rpl_ns_node {
   /* Store only IPv6 link identifiers as all nodes in the DAG share the same prefix */
   unsigned char link_identifier[8];
   struct rpl_ns_node *parent;
+#if RPL_NS_SRH_CACHE
+  /* Generation of the last change to the link of this node */
+  uint32_t generation;
+#endif /* RPL_NS_SRH_CACHE */
 } rpl_ns_node_t;
 
 int rpl_ns_num_nodes(void);
@@ -68,5 +95,12 @@ rpl_ns_node_t *rpl_ns_get_node(const rpl_dag_t *dag, const uip_ipaddr_t *addr);
 int rpl_ns_is_node_reachable(const rpl_dag_t *dag, const uip_ipaddr_t *addr);
 void rpl_ns_get_node_global_addr(uip_ipaddr_t *addr, rpl_ns_node_t *node);
 void rpl_ns_periodic(void);
+/* Get a counter that increases whenever the link of a node changes */
+uint32_t rpl_ns_generation(void);
+#if RPL_NS_SRH_CACHE
+/* Check that no link on the path from a node to the root changed since
+   the given generation */
+int rpl_ns_is_path_unchanged(const rpl_ns_node_t *node, uint32_t since);
+#endif /* RPL_NS_SRH_CACHE */
 
 #endif /* RPL_NS_H */
@@ -46,10 +46,19 @@
 #include "contiki.h"
 #include "lib/list.h"
 
+#include <stddef.h>
+
+/* Callback timers that are set before the ctimer process has started.
+   Once it has started, callback timers are only kept in the event
+   timer queue. */
 LIST(ctimer_list);
 
 static char initialized;
 
+#if CTIMER_STATS
+struct ctimer_stats ctimer_stats;
+#endif /* CTIMER_STATS */
+
 #define DEBUG 0
 #if DEBUG
 #include <stdio.h>
@@ -68,24 +77,57 @@ PROCESS_THREAD(ctimer_process, ev, data)
   for(c = list_head(ctimer_list); c != NULL; c = c->next) {
     etimer_set(&c->etimer, c->etimer.timer.interval);
   }
+  list_init(ctimer_list);
   initialized = 1;
 
+  /* The event timer process calls ctimer_run() for expired timers
+     that belong to this process, so there are no events to handle. */
   while(1) {
-    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
-    for(c = list_head(ctimer_list); c != NULL; c = c->next) {
-      if(&c->etimer == data) {
-	list_remove(ctimer_list, c);
-	PROCESS_CONTEXT_BEGIN(c->p);
-	if(c->f != NULL) {
-	  c->f(c->ptr);
-	}
-	PROCESS_CONTEXT_END(c->p);
-	break;
+    PROCESS_YIELD();
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_run(struct etimer *et)
+{
+  struct ctimer *c;
+
+  c = (struct ctimer *)((char *)et - offsetof(struct ctimer, etimer));
+
+#if CTIMER_STATS
+  {
+    clock_time_t lateness;
+
+    ctimer_stats.fired++;
+    lateness = clock_time() - etimer_expiration_time(et);
+    if(lateness > 0) {
+      ctimer_stats.late++;
+      if(lateness > ctimer_stats.max_lateness) {
+        ctimer_stats.max_lateness = lateness;
       }
     }
   }
-  PROCESS_END();
+#endif /* CTIMER_STATS */
+
+  PROCESS_CONTEXT_BEGIN(c->p);
+  if(c->f != NULL) {
+    c->f(c->ptr);
+  }
+  PROCESS_CONTEXT_END(c->p);
+}
+/*---------------------------------------------------------------------------*/
+#if CTIMER_STATS
+static void
+count_rescheduled(struct ctimer *c)
+{
+  if(!etimer_expired(&c->etimer)) {
+    ctimer_stats.rescheduled++;
+  }
 }
+#else /* CTIMER_STATS */
+#define count_rescheduled(c)
+#endif /* CTIMER_STATS */
 /*---------------------------------------------------------------------------*/
 void
 ctimer_init(void)
@@ -111,38 +153,40 @@ ctimer_set_with_process(struct ctimer *c, clock_time_t t,
   c->f = f;
   c->ptr = ptr;
   if(initialized) {
+    count_rescheduled(c);
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_set(&c->etimer, t);
     PROCESS_CONTEXT_END(&ctimer_process);
   } else {
     c->etimer.timer.interval = t;
+    list_add(ctimer_list, c);
   }
-
-  list_add(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 void
 ctimer_reset(struct ctimer *c)
 {
   if(initialized) {
+    count_rescheduled(c);
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_reset(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
+  } else {
+    list_add(ctimer_list, c);
   }
-
-  list_add(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 void
 ctimer_restart(struct ctimer *c)
 {
   if(initialized) {
+    count_rescheduled(c);
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_restart(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
+  } else {
+    list_add(ctimer_list, c);
   }
-
-  list_add(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -153,8 +197,8 @@ ctimer_stop(struct ctimer *c)
   } else {
     c->etimer.next = NULL;
     c->etimer.p = PROCESS_NONE;
+    list_remove(ctimer_list, c);
   }
-  list_remove(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -49,6 +49,10 @@
  * The ctimer module provides a timer mechanism that calls a specified
  * C function when a ctimer expires.
  *
+ * Callback timers are kept in the same ordered queue as event timers,
+ * and the event timer process calls the function of an expired ctimer
+ * directly instead of posting an event for it.
+ *
  */
 
 #ifndef CTIMER_H_
@@ -64,6 +68,33 @@ struct ctimer {
   void *ptr;
 };
 
+#ifdef CTIMER_CONF_STATS
+#define CTIMER_STATS CTIMER_CONF_STATS
+#else /* CTIMER_CONF_STATS */
+#define CTIMER_STATS 0
+#endif /* CTIMER_CONF_STATS */
+
+#if CTIMER_STATS
+/**
+ * Callback timer statistics, collected when CTIMER_CONF_STATS is set.
+ */
+struct ctimer_stats {
+  /** Number of callback timers that have fired. */
+  unsigned long fired;
+  /** Number of callback timers that fired at least one clock tick
+      after their expiration time. */
+  unsigned long late;
+  /** The largest delay, in clock ticks, between the expiration time
+      of a callback timer and the call of its function. */
+  clock_time_t max_lateness;
+  /** Number of callback timers that were set, reset or restarted
+      while still pending. */
+  unsigned long rescheduled;
+};
+
+extern struct ctimer_stats ctimer_stats;
+#endif /* CTIMER_STATS */
+
 /**
  * \brief      Reset a callback timer with the same interval as was
  *             previously set.
@@ -161,6 +192,19 @@ int ctimer_expired(struct ctimer *c);
  */
 void ctimer_init(void);
 
+/**
+ * \brief      Run the function of an expired callback timer.
+ * \param et   A pointer to the event timer of the callback timer
+ *
+ *             This function is called by the event timer process
+ *             when an event timer that belongs to the callback timer
+ *             process expires, and should not be called from
+ *             application programs.
+ */
+void ctimer_run(struct etimer *et);
+
+PROCESS_NAME(ctimer_process);
+
 #endif /* CTIMER_H_ */
 /** @} */
 /** @} */
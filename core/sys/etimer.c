@@ -47,97 +47,309 @@
 #include "contiki-conf.h"
 
 #include "sys/etimer.h"
+#include "sys/ctimer.h"
 #include "sys/process.h"
 
+/* The pending timers that are not on the heap, sorted by expiration
+   time. Without a heap, this is every pending timer. */
 static struct etimer *timerlist;
-static clock_time_t next_expiration;
+
+#if ETIMER_HEAP_SIZE
+#if ETIMER_HEAP_SIZE >= 0xffff
+#error "ETIMER_CONF_HEAP_SIZE must be less than 65535"
+#endif
+/*
+ * The pending timers are kept in a binary min-heap ordered by the time
+ * left until they expire, as long as there is room. The index field of
+ * a timer is its position in the heap plus one. It is only believed if
+ * that position holds the timer, so a timer in uninitialized memory or
+ * a copy of a pending timer is never taken for a pending one.
+ */
+static struct etimer *heap[ETIMER_HEAP_SIZE];
+static uint16_t heap_len;
+#endif /* ETIMER_HEAP_SIZE */
 
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+/*
+ * The time left until a timer expires, or zero if it has expired.
+ * Unlike the absolute expiration time, this key orders timers
+ * correctly across clock wraps, and since it decreases at the same
+ * rate for all pending timers, the order between two timers never
+ * changes while they are queued.
+ */
+static clock_time_t
+time_left(struct etimer *t, clock_time_t now)
+{
+  clock_time_t diff;
+
+  diff = now - t->timer.start;
+  if(diff >= t->timer.interval) {
+    return 0;
+  }
+  return t->timer.interval - diff;
+}
+/*---------------------------------------------------------------------------*/
 static void
-update_time(void)
+list_insert(struct etimer *et, clock_time_t now)
 {
-  clock_time_t tdist;
-  clock_time_t now;
   struct etimer *t;
+  clock_time_t left;
+
+  left = time_left(et, now);
 
-  if (timerlist == NULL) {
-    next_expiration = 0;
+  /* Insert after any timer that expires at the same time, so that
+     timers with equal expiration times fire in the order they were
+     set. */
+  if(timerlist == NULL || time_left(timerlist, now) > left) {
+    et->next = timerlist;
+    timerlist = et;
   } else {
-    now = clock_time();
+    for(t = timerlist;
+        t->next != NULL && time_left(t->next, now) <= left;
+        t = t->next);
+    et->next = t->next;
+    t->next = et;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+list_remove(struct etimer *et)
+{
+  struct etimer *t;
+
+  /* First check if et is the first event timer on the list. */
+  if(et == timerlist) {
+    timerlist = timerlist->next;
+    et->next = NULL;
+    return 1;
+  }
+
+  /* Else walk through the list and try to find the item before the
+     et timer. */
+  for(t = timerlist; t != NULL && t->next != et; t = t->next);
+
+  if(t != NULL) {
+    /* We've found the item before the event timer that we are about
+       to remove. We point the items next pointer to the event after
+       the removed item. */
+    t->next = et->next;
+    et->next = NULL;
+    return 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+list_remove_process(struct process *p)
+{
+  struct etimer *t;
+
+  while(timerlist != NULL && timerlist->p == p) {
+    timerlist = timerlist->next;
+  }
+
+  if(timerlist != NULL) {
     t = timerlist;
-    /* Must calculate distance to next time into account due to wraps */
-    tdist = t->timer.start + t->timer.interval - now;
-    for(t = t->next; t != NULL; t = t->next) {
-      if(t->timer.start + t->timer.interval - now < tdist) {
-	tdist = t->timer.start + t->timer.interval - now;
+    while(t->next != NULL) {
+      if(t->next->p == p) {
+        t->next = t->next->next;
+      } else {
+        t = t->next;
       }
     }
-    next_expiration = now + tdist;
   }
 }
 /*---------------------------------------------------------------------------*/
+#if ETIMER_HEAP_SIZE
+static void
+place(struct etimer *t, uint16_t i)
+{
+  heap[i] = t;
+  t->index = i + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sift_up(uint16_t i, clock_time_t now)
+{
+  struct etimer *t;
+  clock_time_t left;
+  uint16_t parent;
+
+  t = heap[i];
+  left = time_left(t, now);
+  while(i > 0) {
+    parent = (i - 1) / 2;
+    if(time_left(heap[parent], now) <= left) {
+      break;
+    }
+    place(heap[parent], i);
+    i = parent;
+  }
+  place(t, i);
+}
+/*---------------------------------------------------------------------------*/
+static void
+sift_down(uint16_t i, clock_time_t now)
+{
+  struct etimer *t;
+  clock_time_t left;
+  uint16_t child;
+
+  t = heap[i];
+  left = time_left(t, now);
+  while((child = 2 * i + 1) < heap_len) {
+    if(child + 1 < heap_len &&
+       time_left(heap[child + 1], now) < time_left(heap[child], now)) {
+      child++;
+    }
+    if(time_left(heap[child], now) >= left) {
+      break;
+    }
+    place(heap[child], i);
+    i = child;
+  }
+  place(t, i);
+}
+/*---------------------------------------------------------------------------*/
+static int
+on_heap(struct etimer *et)
+{
+  return et->index > 0 && et->index <= heap_len && heap[et->index - 1] == et;
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert_timer(struct etimer *et)
+{
+  clock_time_t now;
+
+  now = clock_time();
+  if(heap_len == ETIMER_HEAP_SIZE) {
+    /* The heap is full, fall back to the list */
+    list_insert(et, now);
+    return;
+  }
+  place(et, heap_len++);
+  sift_up(heap_len - 1, now);
+}
+/*---------------------------------------------------------------------------*/
+static int
+remove_timer(struct etimer *et)
+{
+  struct etimer *last;
+  clock_time_t now;
+  uint16_t i;
+
+  if(!on_heap(et)) {
+    return list_remove(et);
+  }
+
+  i = et->index - 1;
+  et->index = 0;
+  heap_len--;
+  if(i < heap_len) {
+    now = clock_time();
+    last = heap[heap_len];
+    place(last, i);
+    sift_down(i, now);
+    sift_up(last->index - 1, now);
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_process_timers(struct process *p)
+{
+  clock_time_t now;
+  uint16_t i, j;
+
+  /* Keep the timers that do not belong to the process and restore the
+     heap order bottom-up */
+  for(i = j = 0; i < heap_len; i++) {
+    if(heap[i]->p == p) {
+      heap[i]->index = 0;
+    } else {
+      place(heap[i], j++);
+    }
+  }
+  heap_len = j;
+  now = clock_time();
+  for(i = heap_len / 2; i > 0; i--) {
+    sift_down(i - 1, now);
+  }
+
+  list_remove_process(p);
+}
+/*---------------------------------------------------------------------------*/
+/* The timer that expires first */
+static struct etimer *
+first_timer(void)
+{
+  clock_time_t now;
+
+  if(heap_len == 0) {
+    return timerlist;
+  }
+  if(timerlist == NULL) {
+    return heap[0];
+  }
+  now = clock_time();
+  return time_left(timerlist, now) < time_left(heap[0], now) ?
+    timerlist : heap[0];
+}
+#else /* ETIMER_HEAP_SIZE */
+#define insert_timer(et) list_insert(et, clock_time())
+#define remove_timer(et) list_remove(et)
+#define remove_process_timers(p) list_remove_process(p)
+#define first_timer() timerlist
+#endif /* ETIMER_HEAP_SIZE */
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
-  struct etimer *t, *u;
-	
+  struct etimer *t;
+
   PROCESS_BEGIN();
 
   timerlist = NULL;
-  
+#if ETIMER_HEAP_SIZE
+  heap_len = 0;
+#endif /* ETIMER_HEAP_SIZE */
+
   while(1) {
     PROCESS_YIELD();
 
     if(ev == PROCESS_EVENT_EXITED) {
-      struct process *p = data;
-
-      while(timerlist != NULL && timerlist->p == p) {
-	timerlist = timerlist->next;
-      }
-
-      if(timerlist != NULL) {
-	t = timerlist;
-	while(t->next != NULL) {
-	  if(t->next->p == p) {
-	    t->next = t->next->next;
-	  } else
-	    t = t->next;
-	}
-      }
+      remove_process_timers(data);
       continue;
     } else if(ev != PROCESS_EVENT_POLL) {
       continue;
     }
 
-  again:
-    
-    u = NULL;
-    
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(timer_expired(&t->timer)) {
-	if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
-	  
-	  /* Reset the process ID of the event timer, to signal that the
-	     etimer has expired. This is later checked in the
-	     etimer_expired() function. */
-	  t->p = PROCESS_NONE;
-	  if(u != NULL) {
-	    u->next = t->next;
-	  } else {
-	    timerlist = t->next;
-	  }
-	  t->next = NULL;
-	  update_time();
-	  goto again;
-	} else {
-	  etimer_request_poll();
-	}
+    /* The timers are ordered by expiration time, so only the first
+       timer needs to be checked. */
+    while((t = first_timer()) != NULL && timer_expired(&t->timer)) {
+      if(t->p == &ctimer_process) {
+        /* Callback timers are run directly, without going through
+           the event queue. The timer is taken off the queue first,
+           since the callback may set it again. */
+        remove_timer(t);
+        t->p = PROCESS_NONE;
+        ctimer_run(t);
+        continue;
+      }
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) != PROCESS_ERR_OK) {
+        etimer_request_poll();
+        break;
       }
-      u = t;
+      remove_timer(t);
+
+      /* Reset the process ID of the event timer, to signal that the
+         etimer has expired. This is later checked in the
+         etimer_expired() function. */
+      t->p = PROCESS_NONE;
     }
-    
   }
-  
+
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
@@ -150,27 +362,23 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
-  struct etimer *t;
-
   etimer_request_poll();
 
+#if ETIMER_HEAP_SIZE
+  /* The timer may already be pending; take it out before it is
+     inserted at its new position. Whether it is on the heap is
+     cheap to check, so its process is not trusted for this. */
+  remove_timer(timer);
+#else /* ETIMER_HEAP_SIZE */
   if(timer->p != PROCESS_NONE) {
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(t == timer) {
-	/* Timer already on list, bail out. */
-        timer->p = PROCESS_CURRENT();
-	update_time();
-	return;
-      }
-    }
+    /* The timer may already be pending; take it out before it is
+       inserted at its new position. */
+    remove_timer(timer);
   }
+#endif /* ETIMER_HEAP_SIZE */
 
-  /* Timer not on list. */
   timer->p = PROCESS_CURRENT();
-  timer->next = timerlist;
-  timerlist = timer;
-
-  update_time();
+  insert_timer(timer);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -205,8 +413,13 @@ etimer_restart(struct etimer *et)
 void
 etimer_adjust(struct etimer *et, int timediff)
 {
+  int pending;
+
+  pending = remove_timer(et);
   et->timer.start += timediff;
-  update_time();
+  if(pending) {
+    insert_timer(et);
+  }
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -230,41 +443,24 @@ etimer_start_time(struct etimer *et)
 int
 etimer_pending(void)
 {
+#if ETIMER_HEAP_SIZE
+  return heap_len > 0 || timerlist != NULL;
+#else /* ETIMER_HEAP_SIZE */
   return timerlist != NULL;
+#endif /* ETIMER_HEAP_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t
 etimer_next_expiration_time(void)
 {
-  return etimer_pending() ? next_expiration : 0;
+  return etimer_pending() ? etimer_expiration_time(first_timer()) : 0;
 }
 /*---------------------------------------------------------------------------*/
 void
 etimer_stop(struct etimer *et)
 {
-  struct etimer *t;
-
-  /* First check if et is the first event timer on the list. */
-  if(et == timerlist) {
-    timerlist = timerlist->next;
-    update_time();
-  } else {
-    /* Else walk through the list and try to find the item before the
-       et timer. */
-    for(t = timerlist; t != NULL && t->next != et; t = t->next);
-
-    if(t != NULL) {
-      /* We've found the item before the event timer that we are about
-	 to remove. We point the items next pointer to the event after
-	 the removed item. */
-      t->next = et->next;
-
-      update_time();
-    }
-  }
+  remove_timer(et);
 
-  /* Remove the next pointer from the item to be removed. */
-  et->next = NULL;
   /* Set the timer as expired */
   et->p = PROCESS_NONE;
 }
@@ -65,6 +65,29 @@
 #include "sys/timer.h"
 #include "sys/process.h"
 
+/**
+ * \brief Number of pending event timers kept in a heap.
+ *
+ * By default, pending event timers are kept on a list that is sorted
+ * by expiration time. The next expiration time is available in
+ * constant time and expired timers are dispatched from the head of
+ * the list, but adding, resetting or stopping a timer costs a walk
+ * over the list, O(n) in the number of pending timers.
+ *
+ * Nodes with a large number of timers can set ETIMER_CONF_HEAP_SIZE
+ * to keep up to that many timers in a binary heap instead, which
+ * makes adding, resetting and stopping a timer O(log n), at the cost
+ * of one pointer per heap slot and an index in each event timer.
+ * Timers set while the heap is full go on the sorted list, so the
+ * size should cover the timers the node keeps pending. Event timers
+ * need no initialization with or without the heap.
+ */
+#ifdef ETIMER_CONF_HEAP_SIZE
+#define ETIMER_HEAP_SIZE ETIMER_CONF_HEAP_SIZE
+#else /* ETIMER_CONF_HEAP_SIZE */
+#define ETIMER_HEAP_SIZE 0
+#endif /* ETIMER_CONF_HEAP_SIZE */
+
 /**
  * A timer.
  *
@@ -77,6 +100,9 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_HEAP_SIZE
+  uint16_t index;
+#endif /* ETIMER_HEAP_SIZE */
 };
 
 /**
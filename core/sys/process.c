@@ -44,6 +44,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "sys/process.h"
 #include "sys/arg.h"
@@ -63,13 +64,29 @@ struct event_data {
   process_event_t ev;
   process_data_t data;
   struct process *p;
+  process_num_events_t next;
+#if PROCESS_STATS_PER_PROCESS
+  rtimer_clock_t posted;
+#endif /* PROCESS_STATS_PER_PROCESS */
 };
 
-static process_num_events_t nevents, fevent;
+/*
+ * The event slots are linked through their next fields, either into
+ * the free list or into the FIFO of a priority level. NO_EVENT ends a
+ * list.
+ */
+#define NO_EVENT PROCESS_CONF_NUMEVENTS
+
+static process_num_events_t nevents, free_events;
+static process_num_events_t first_event[PROCESS_NUM_PRIORITIES];
+static process_num_events_t last_event[PROCESS_NUM_PRIORITIES];
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
 
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
+#if PROCESS_COALESCE
+unsigned long process_coalesced;
+#endif /* PROCESS_COALESCE */
 #endif
 
 static volatile unsigned char poll_requested;
@@ -98,14 +115,10 @@ process_alloc_event(void)
 void
 process_start(struct process *p, process_data_t data)
 {
-  struct process *q;
-
   /* First make sure that we don't try to start a process that is
-     already running. */
-  for(q = process_list; q != p && q != NULL; q = q->next);
-
-  /* If we found the process on the process list, we bail out. */
-  if(q == p) {
+     already running. A process is on the process list exactly when
+     it is running. */
+  if(process_is_running(p)) {
     return;
   }
   /* Put on the procs list.*/
@@ -130,33 +143,15 @@ exit_process(struct process *p, struct process *fromprocess)
 
   /* Make sure the process is in the process list before we try to
      exit it. */
-  for(q = process_list; q != p && q != NULL; q = q->next);
-  if(q == NULL) {
+  if(!process_is_running(p)) {
     return;
   }
 
-  if(process_is_running(p)) {
-    /* Process was running */
-    p->state = PROCESS_STATE_NONE;
-
-    /*
-     * Post a synchronous event to all processes to inform them that
-     * this process is about to exit. This will allow services to
-     * deallocate state associated with this process.
-     */
-    for(q = process_list; q != NULL; q = q->next) {
-      if(p != q) {
-	call_process(q, PROCESS_EVENT_EXITED, (process_data_t)p);
-      }
-    }
-
-    if(p->thread != NULL && p != fromprocess) {
-      /* Post the exit event to the process that is about to exit. */
-      process_current = p;
-      p->thread(&p->pt, PROCESS_EVENT_EXIT, NULL);
-    }
-  }
-
+  /* Take the process off the list before anyone is told that it
+     exits, so that it can be started again from an exit handler. The
+     next pointer is left as is for any loop that is currently
+     walking the list. */
+  p->state = PROCESS_STATE_NONE;
   if(p == process_list) {
     process_list = process_list->next;
   } else {
@@ -168,13 +163,62 @@ exit_process(struct process *p, struct process *fromprocess)
     }
   }
 
+  /*
+   * Post a synchronous event to all processes to inform them that
+   * this process is about to exit. This will allow services to
+   * deallocate state associated with this process.
+   */
+  for(q = process_list; q != NULL; q = q->next) {
+    call_process(q, PROCESS_EVENT_EXITED, (process_data_t)p);
+  }
+
+  if(p->thread != NULL && p != fromprocess) {
+    /* Post the exit event to the process that is about to exit. */
+    process_current = p;
+    p->thread(&p->pt, PROCESS_EVENT_EXIT, NULL);
+  }
+
   process_current = old_current;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_PROFILE
+/* Time spent in processes called from within the current call */
+static rtimer_clock_t profile_nested;
+
+static void
+profile_record(struct process *p, rtimer_clock_t time)
+{
+  uint8_t bin;
+
+  p->profile.calls++;
+  p->profile.time += time;
+  if(time > p->profile.max_time) {
+    p->profile.max_time = time;
+  }
+  for(bin = 0; time > 0 && bin < PROCESS_PROFILE_BINS - 1; bin++) {
+    time >>= 1;
+  }
+  p->profile.histogram[bin]++;
+}
+/*---------------------------------------------------------------------------*/
+void
+process_profile_reset(void)
+{
+  struct process *p;
+
+  for(p = process_list; p != NULL; p = p->next) {
+    memset(&p->profile, 0, sizeof(p->profile));
+  }
+}
+#endif /* PROCESS_PROFILE */
+/*---------------------------------------------------------------------------*/
 static void
 call_process(struct process *p, process_event_t ev, process_data_t data)
 {
   int ret;
+#if PROCESS_PROFILE
+  rtimer_clock_t start, elapsed, outer_nested;
+#endif /* PROCESS_PROFILE */
 
 #if DEBUG
   if(p->state == PROCESS_STATE_CALLED) {
@@ -187,7 +231,17 @@ call_process(struct process *p, process_event_t ev, process_data_t data)
     PRINTF("process: calling process '%s' with event %d\n", PROCESS_NAME_STRING(p), ev);
     process_current = p;
     p->state = PROCESS_STATE_CALLED;
+#if PROCESS_PROFILE
+    outer_nested = profile_nested;
+    profile_nested = 0;
+    start = RTIMER_NOW();
+#endif /* PROCESS_PROFILE */
     ret = p->thread(&p->pt, ev, data);
+#if PROCESS_PROFILE
+    elapsed = RTIMER_NOW() - start;
+    profile_record(p, elapsed - profile_nested);
+    profile_nested = outer_nested + elapsed;
+#endif /* PROCESS_PROFILE */
     if(ret == PT_EXITED ||
        ret == PT_ENDED ||
        ev == PROCESS_EVENT_EXIT) {
@@ -207,11 +261,23 @@ process_exit(struct process *p)
 void
 process_init(void)
 {
+  process_num_events_t i;
+
   lastevent = PROCESS_EVENT_MAX;
 
-  nevents = fevent = 0;
+  nevents = 0;
+  for(i = 0; i < PROCESS_CONF_NUMEVENTS; i++) {
+    events[i].next = i + 1;
+  }
+  free_events = 0;
+  for(i = 0; i < PROCESS_NUM_PRIORITIES; i++) {
+    first_event[i] = last_event[i] = NO_EVENT;
+  }
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+#if PROCESS_COALESCE
+  process_coalesced = 0;
+#endif /* PROCESS_COALESCE */
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
@@ -249,28 +315,53 @@ do_event(void)
   process_data_t data;
   struct process *receiver;
   struct process *p;
-  
+  process_num_events_t i;
+  int priority;
+
   /*
-   * If there are any events in the queue, take the first one and walk
-   * through the list of processes to see if the event should be
-   * delivered to any of them. If so, we call the event handler
-   * function for the process. We only process one event at a time and
-   * call the poll handlers inbetween.
+   * If there are any events in the queue, take the first one of the
+   * highest priority and walk through the list of processes to see if
+   * the event should be delivered to any of them. If so, we call the
+   * event handler function for the process. We only process one event
+   * at a time and call the poll handlers inbetween.
    */
 
   if(nevents > 0) {
-    
+
+    for(priority = PROCESS_NUM_PRIORITIES - 1;
+        first_event[priority] == NO_EVENT;
+        priority--);
+
     /* There are events that we should deliver. */
-    ev = events[fevent].ev;
-    
-    data = events[fevent].data;
-    receiver = events[fevent].p;
+    i = first_event[priority];
+    ev = events[i].ev;
+    data = events[i].data;
+    receiver = events[i].p;
 
-    /* Since we have seen the new event, we move pointer upwards
+    /* Since we have seen the new event, we move it to the free list
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    first_event[priority] = events[i].next;
+    if(first_event[priority] == NO_EVENT) {
+      last_event[priority] = NO_EVENT;
+    }
+    events[i].next = free_events;
+    free_events = i;
     --nevents;
 
+#if PROCESS_STATS_PER_PROCESS
+    if(receiver != PROCESS_BROADCAST) {
+      rtimer_clock_t latency;
+
+      latency = RTIMER_NOW() - events[i].posted;
+      receiver->stats.nevents--;
+      receiver->stats.dispatched++;
+      receiver->stats.total_latency += latency;
+      if(latency > receiver->stats.max_latency) {
+        receiver->stats.max_latency = latency;
+      }
+    }
+#endif /* PROCESS_STATS_PER_PROCESS */
+
     /* If this is a broadcast event, we deliver it to all events, in
        order of their priority. */
     if(receiver == PROCESS_BROADCAST) {
@@ -322,6 +413,7 @@ int
 process_post(struct process *p, process_event_t ev, process_data_t data)
 {
   process_num_events_t snum;
+  int priority;
 
   if(PROCESS_CURRENT() == NULL) {
     PRINTF("process_post: NULL process posts event %d to process '%s', nevents %d\n",
@@ -332,6 +424,27 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
 	   p == PROCESS_BROADCAST? "<broadcast>": PROCESS_NAME_STRING(p), nevents);
   }
   
+#if PROCESS_NUM_PRIORITIES > 1
+  priority = p == PROCESS_BROADCAST ? PROCESS_PRIORITY_NORMAL : p->priority;
+#else /* PROCESS_NUM_PRIORITIES > 1 */
+  priority = 0;
+#endif /* PROCESS_NUM_PRIORITIES > 1 */
+
+#if PROCESS_COALESCE
+  /* An identical event that is still waiting will be delivered
+     anyway. */
+  for(snum = first_event[priority]; snum != NO_EVENT;
+      snum = events[snum].next) {
+    if(events[snum].p == p && events[snum].ev == ev &&
+       events[snum].data == data) {
+#if PROCESS_CONF_STATS
+      process_coalesced++;
+#endif /* PROCESS_CONF_STATS */
+      return PROCESS_ERR_OK;
+    }
+  }
+#endif /* PROCESS_COALESCE */
+
   if(nevents == PROCESS_CONF_NUMEVENTS) {
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
@@ -342,11 +455,19 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
 #endif /* DEBUG */
     return PROCESS_ERR_FULL;
   }
-  
-  snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
+
+  snum = free_events;
+  free_events = events[snum].next;
   events[snum].ev = ev;
   events[snum].data = data;
   events[snum].p = p;
+  events[snum].next = NO_EVENT;
+  if(last_event[priority] == NO_EVENT) {
+    first_event[priority] = snum;
+  } else {
+    events[last_event[priority]].next = snum;
+  }
+  last_event[priority] = snum;
   ++nevents;
 
 #if PROCESS_CONF_STATS
@@ -354,7 +475,17 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
     process_maxevents = nevents;
   }
 #endif /* PROCESS_CONF_STATS */
-  
+
+#if PROCESS_STATS_PER_PROCESS
+  events[snum].posted = RTIMER_NOW();
+  if(p != PROCESS_BROADCAST) {
+    p->stats.nevents++;
+    if(p->stats.nevents > p->stats.maxevents) {
+      p->stats.maxevents = p->stats.nevents;
+    }
+  }
+#endif /* PROCESS_STATS_PER_PROCESS */
+
   return PROCESS_ERR_OK;
 }
 /*---------------------------------------------------------------------------*/
@@ -385,4 +516,15 @@ process_is_running(struct process *p)
   return p->state != PROCESS_STATE_NONE;
 }
 /*---------------------------------------------------------------------------*/
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+#if PROCESS_NUM_PRIORITIES > 1
+  if(priority > PROCESS_PRIORITY_HIGH) {
+    priority = PROCESS_PRIORITY_HIGH;
+  }
+  p->priority = priority;
+#endif /* PROCESS_NUM_PRIORITIES > 1 */
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
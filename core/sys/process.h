@@ -88,6 +88,70 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/*
+ * The number of priority levels for events. Events posted to a
+ * process are queued at the priority of the process, and an event of
+ * a higher priority is always delivered before any event of a lower
+ * one. With the default of a single level, all events are delivered
+ * in the order they were posted.
+ */
+#ifdef PROCESS_CONF_NUM_PRIORITIES
+#define PROCESS_NUM_PRIORITIES PROCESS_CONF_NUM_PRIORITIES
+#else /* PROCESS_CONF_NUM_PRIORITIES */
+#define PROCESS_NUM_PRIORITIES 1
+#endif /* PROCESS_CONF_NUM_PRIORITIES */
+
+#define PROCESS_PRIORITY_NORMAL 0
+#define PROCESS_PRIORITY_HIGH   (PROCESS_NUM_PRIORITIES - 1)
+
+/*
+ * If PROCESS_CONF_COALESCE is set, posting an event that is identical
+ * to one already waiting in the queue (same process, event and data)
+ * does not queue a second copy; process_post() returns PROCESS_ERR_OK
+ * and the event is delivered once.
+ */
+#ifdef PROCESS_CONF_COALESCE
+#define PROCESS_COALESCE PROCESS_CONF_COALESCE
+#else /* PROCESS_CONF_COALESCE */
+#define PROCESS_COALESCE 0
+#endif /* PROCESS_CONF_COALESCE */
+
+/*
+ * PROCESS_CONF_STATS_PER_PROCESS, together with PROCESS_CONF_STATS,
+ * keeps the event queue depth and the dispatch latency of each
+ * process in its process structure.
+ */
+#if PROCESS_CONF_STATS && PROCESS_CONF_STATS_PER_PROCESS
+#define PROCESS_STATS_PER_PROCESS 1
+#include "sys/rtimer.h"
+#else
+#define PROCESS_STATS_PER_PROCESS 0
+#endif
+
+/*
+ * PROCESS_CONF_PROFILE measures, on the rtimer clock, how long each
+ * call of a process runs, excluding the processes that it calls
+ * synchronously, and keeps the figures in its process structure.
+ */
+#ifdef PROCESS_CONF_PROFILE
+#define PROCESS_PROFILE PROCESS_CONF_PROFILE
+#else /* PROCESS_CONF_PROFILE */
+#define PROCESS_PROFILE 0
+#endif /* PROCESS_CONF_PROFILE */
+
+#if PROCESS_PROFILE
+#include "sys/rtimer.h"
+#endif /* PROCESS_PROFILE */
+
+/* Number of bins in the run time histogram. Bin 0 counts calls that
+   took less than one rtimer tick, bin n calls that took from 2^(n-1)
+   up to 2^n - 1 ticks. The last bin also counts all longer calls. */
+#ifdef PROCESS_CONF_PROFILE_BINS
+#define PROCESS_PROFILE_BINS PROCESS_CONF_PROFILE_BINS
+#else /* PROCESS_CONF_PROFILE_BINS */
+#define PROCESS_PROFILE_BINS 8
+#endif /* PROCESS_CONF_PROFILE_BINS */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -312,6 +376,42 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
 
 /** @} */
 
+#if PROCESS_STATS_PER_PROCESS
+/**
+ * Event statistics of a process.
+ */
+struct process_stats {
+  /** Number of events currently waiting for the process. */
+  process_num_events_t nevents;
+  /** Largest number of events that have been waiting at once. */
+  process_num_events_t maxevents;
+  /** Number of events delivered to the process. */
+  unsigned long dispatched;
+  /** Sum of the times, in rtimer ticks, that the delivered events
+      spent in the queue. */
+  unsigned long total_latency;
+  /** Longest time, in rtimer ticks, that an event spent in the
+      queue. */
+  rtimer_clock_t max_latency;
+};
+#endif /* PROCESS_STATS_PER_PROCESS */
+
+#if PROCESS_PROFILE
+/**
+ * Run time profile of a process, in rtimer ticks.
+ */
+struct process_profile {
+  /** Number of times the process has been called. */
+  unsigned long calls;
+  /** Total time spent in the process. */
+  unsigned long time;
+  /** Longest time spent in a single call. */
+  rtimer_clock_t max_time;
+  /** Histogram of the time spent per call. */
+  unsigned long histogram[PROCESS_PROFILE_BINS];
+};
+#endif /* PROCESS_PROFILE */
+
 struct process {
   struct process *next;
 #if PROCESS_CONF_NO_PROCESS_NAMES
@@ -323,6 +423,15 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_NUM_PRIORITIES > 1
+  unsigned char priority;
+#endif /* PROCESS_NUM_PRIORITIES > 1 */
+#if PROCESS_STATS_PER_PROCESS
+  struct process_stats stats;
+#endif /* PROCESS_STATS_PER_PROCESS */
+#if PROCESS_PROFILE
+  struct process_profile profile;
+#endif /* PROCESS_PROFILE */
 };
 
 /**
@@ -511,6 +620,16 @@ int process_run(void);
  */
 CCIF int process_is_running(struct process *p);
 
+/**
+ * Set the priority of the events posted to a process.
+ *
+ * \param p The process.
+ * \param priority PROCESS_PRIORITY_NORMAL, PROCESS_PRIORITY_HIGH, or
+ * any level in between. Has no effect unless
+ * PROCESS_CONF_NUM_PRIORITIES is larger than one.
+ */
+void process_set_priority(struct process *p, unsigned char priority);
+
 /**
  *  Number of events waiting to be processed.
  *
@@ -519,6 +638,20 @@ CCIF int process_is_running(struct process *p);
  */
 int process_nevents(void);
 
+#if PROCESS_CONF_STATS
+/** Largest number of events that have been waiting at once. */
+extern process_num_events_t process_maxevents;
+#if PROCESS_COALESCE
+/** Number of events that were merged into an identical pending event. */
+extern unsigned long process_coalesced;
+#endif /* PROCESS_COALESCE */
+#endif /* PROCESS_CONF_STATS */
+
+#if PROCESS_PROFILE
+/** Clear the run time profiles of all running processes. */
+void process_profile_reset(void);
+#endif /* PROCESS_PROFILE */
+
 /** @} */
 
 CCIF extern struct process *process_list;
@@ -54,8 +54,34 @@
 #define PRINTF(...)
 #endif
 
-static struct rtimer *next_rtimer;
+#if RTIMER_STATS
+struct rtimer_stats rtimer_stats;
+#endif /* RTIMER_STATS */
 
+/*---------------------------------------------------------------------------*/
+#if RTIMER_STATS
+static void
+record_lateness(struct rtimer *t)
+{
+  rtimer_clock_t now;
+  rtimer_clock_t lateness;
+  int bin;
+
+  now = RTIMER_NOW();
+  lateness = RTIMER_CLOCK_LT(now, t->time) ? 0 : now - t->time;
+
+  rtimer_stats.fired++;
+  if(lateness > rtimer_stats.max_lateness) {
+    rtimer_stats.max_lateness = lateness;
+  }
+  for(bin = 0; lateness > 0 && bin < RTIMER_STATS_BINS - 1; bin++) {
+    lateness >>= 1;
+  }
+  rtimer_stats.lateness[bin]++;
+}
+#else /* RTIMER_STATS */
+#define record_lateness(t)
+#endif /* RTIMER_STATS */
 /*---------------------------------------------------------------------------*/
 void
 rtimer_init(void)
@@ -63,6 +89,238 @@ rtimer_init(void)
   rtimer_arch_init();
 }
 /*---------------------------------------------------------------------------*/
+#if RTIMER_MULTIPLE
+#if RTIMER_QUEUE_SIZE >= 255
+#error "RTIMER_CONF_QUEUE_SIZE must be less than 255"
+#endif
+/*
+ * The pending tasks are kept in a binary min-heap ordered by time and
+ * priority. The index field of a task is its position in the heap
+ * plus one, or zero if the task is not pending. It is only believed if
+ * that position holds the task, so a task in uninitialized memory is
+ * never taken for a pending one.
+ */
+static struct rtimer *queue[RTIMER_QUEUE_SIZE];
+static uint8_t queue_len;
+
+/* Marks a task that has been taken off the queue by rtimer_run_next()
+   but not yet executed. */
+#define INDEX_DUE 0xff
+
+/* Set while rtimer_run_next() executes tasks; it schedules the
+   hardware timer itself when it is done. */
+static uint8_t running;
+/*---------------------------------------------------------------------------*/
+static int
+before(const struct rtimer *a, const struct rtimer *b)
+{
+  if(a->time == b->time) {
+    return a->priority < b->priority;
+  }
+  return RTIMER_CLOCK_LT(a->time, b->time);
+}
+/*---------------------------------------------------------------------------*/
+static void
+place(struct rtimer *t, uint8_t i)
+{
+  queue[i] = t;
+  t->index = i + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sift_up(uint8_t i)
+{
+  struct rtimer *t;
+  uint8_t parent;
+
+  t = queue[i];
+  while(i > 0) {
+    parent = (i - 1) / 2;
+    if(!before(t, queue[parent])) {
+      break;
+    }
+    place(queue[parent], i);
+    i = parent;
+  }
+  place(t, i);
+}
+/*---------------------------------------------------------------------------*/
+static void
+sift_down(uint8_t i)
+{
+  struct rtimer *t;
+  uint8_t child;
+
+  t = queue[i];
+  while((child = 2 * i + 1) < queue_len) {
+    if(child + 1 < queue_len && before(queue[child + 1], queue[child])) {
+      child++;
+    }
+    if(!before(queue[child], t)) {
+      break;
+    }
+    place(queue[child], i);
+    i = child;
+  }
+  place(t, i);
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_at(uint8_t i)
+{
+  struct rtimer *last;
+
+  queue[i]->index = 0;
+  queue_len--;
+  if(i < queue_len) {
+    last = queue[queue_len];
+    place(last, i);
+    sift_down(i);
+    sift_up(last->index - 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+queued(const struct rtimer *t)
+{
+  return t->index > 0 && t->index <= queue_len && queue[t->index - 1] == t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+schedule_first(void)
+{
+  if(!running && queue_len > 0) {
+    rtimer_arch_schedule(queue[0]->time);
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_set_with_priority(struct rtimer *rtimer, rtimer_clock_t time,
+                         rtimer_callback_t func, void *ptr,
+                         uint8_t priority)
+{
+  struct rtimer *first;
+  rtimer_clock_t first_time;
+
+  PRINTF("rtimer_set time %d\n", time);
+
+  first = queue_len > 0 ? queue[0] : NULL;
+  first_time = first != NULL ? first->time : 0;
+
+  rtimer->func = func;
+  rtimer->ptr = ptr;
+  rtimer->time = time;
+  rtimer->priority = priority;
+
+  if(queued(rtimer)) {
+    /* Already pending: move the task to its new position. */
+    sift_up(rtimer->index - 1);
+    sift_down(rtimer->index - 1);
+  } else {
+    /* Whatever the index held, the task is not pending now; this also
+       keeps rtimer_run_next() from running a due task that could not
+       be set again */
+    rtimer->index = 0;
+    if(queue_len == RTIMER_QUEUE_SIZE) {
+#if RTIMER_STATS
+      rtimer_stats.full++;
+#endif /* RTIMER_STATS */
+      return RTIMER_ERR_FULL;
+    }
+    place(rtimer, queue_len++);
+    sift_up(queue_len - 1);
+  }
+
+#if RTIMER_STATS
+  rtimer_stats.scheduled++;
+#endif /* RTIMER_STATS */
+
+  if(queue[0] != first || queue[0]->time != first_time) {
+    schedule_first();
+  }
+  return RTIMER_OK;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_set(struct rtimer *rtimer, rtimer_clock_t time,
+	   rtimer_clock_t duration,
+	   rtimer_callback_t func, void *ptr)
+{
+  return rtimer_set_with_priority(rtimer, time, func, ptr,
+                                  RTIMER_PRIORITY_DEFAULT);
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_stop(struct rtimer *rtimer)
+{
+  struct rtimer *first;
+
+  if(queued(rtimer)) {
+    first = queue[0];
+    remove_at(rtimer->index - 1);
+    if(queue_len > 0 && queue[0] != first) {
+      schedule_first();
+    }
+  } else {
+    /* Not pending, or taken off the queue by rtimer_run_next(), which
+       will skip it */
+    rtimer->index = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_run_next(void)
+{
+  struct rtimer *due[RTIMER_QUEUE_SIZE];
+  struct rtimer *t;
+  rtimer_clock_t now;
+  uint8_t n, i, j;
+
+  running = 1;
+  while(queue_len > 0) {
+    /* The first task is due when the hardware timer fires. Any other
+       task that is due by now runs in the same pass. */
+    now = RTIMER_NOW();
+    n = 0;
+    do {
+      due[n++] = queue[0];
+      remove_at(0);
+      due[n - 1]->index = INDEX_DUE;
+    } while(queue_len > 0 && !RTIMER_CLOCK_LT(now, queue[0]->time));
+
+    /* Run the most critical of the due tasks first. The tasks were
+       taken off the queue in time order, which insertion sort keeps
+       for tasks with the same priority. */
+    for(i = 1; i < n; i++) {
+      t = due[i];
+      for(j = i; j > 0 && due[j - 1]->priority > t->priority; j--) {
+        due[j] = due[j - 1];
+      }
+      due[j] = t;
+    }
+
+    for(i = 0; i < n; i++) {
+      t = due[i];
+      /* The task may have been stopped or set again by a task that
+         ran before it. */
+      if(t->index == INDEX_DUE) {
+        t->index = 0;
+        record_lateness(t);
+        t->func(t, t->ptr);
+      }
+    }
+
+    if(queue_len == 0 || RTIMER_CLOCK_LT(RTIMER_NOW(), queue[0]->time)) {
+      break;
+    }
+  }
+  running = 0;
+  schedule_first();
+}
+/*---------------------------------------------------------------------------*/
+#else /* RTIMER_MULTIPLE */
+static struct rtimer *next_rtimer;
+/*---------------------------------------------------------------------------*/
 int
 rtimer_set(struct rtimer *rtimer, rtimer_clock_t time,
 	   rtimer_clock_t duration,
@@ -82,12 +340,32 @@ rtimer_set(struct rtimer *rtimer, rtimer_clock_t time,
   rtimer->time = time;
   next_rtimer = rtimer;
 
+#if RTIMER_STATS
+  rtimer_stats.scheduled++;
+#endif /* RTIMER_STATS */
+
   if(first == 1) {
     rtimer_arch_schedule(time);
   }
   return RTIMER_OK;
 }
 /*---------------------------------------------------------------------------*/
+int
+rtimer_set_with_priority(struct rtimer *rtimer, rtimer_clock_t time,
+                         rtimer_callback_t func, void *ptr,
+                         uint8_t priority)
+{
+  return rtimer_set(rtimer, time, 0, func, ptr);
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_stop(struct rtimer *rtimer)
+{
+  if(next_rtimer == rtimer) {
+    next_rtimer = NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
 void
 rtimer_run_next(void)
 {
@@ -97,12 +375,14 @@ rtimer_run_next(void)
   }
   t = next_rtimer;
   next_rtimer = NULL;
+  record_lateness(t);
   t->func(t, t->ptr);
   if(next_rtimer != NULL) {
     rtimer_arch_schedule(next_rtimer->time);
   }
   return;
 }
+#endif /* RTIMER_MULTIPLE */
 /*---------------------------------------------------------------------------*/
 
 /** @}*/
@@ -76,6 +76,57 @@ void rtimer_init(void);
 struct rtimer;
 typedef void (* rtimer_callback_t)(struct rtimer *t, void *ptr);
 
+/*
+ * By default, only one real-time task can be pending at a time, and
+ * setting a task replaces the pending one. With RTIMER_CONF_MULTIPLE,
+ * up to RTIMER_CONF_QUEUE_SIZE tasks are kept in a queue ordered by
+ * time, and the hardware timer is always scheduled for the first
+ * one. Tasks that are due at the same time run in priority order.
+ *
+ * In either mode, rtimer_set() and rtimer_stop() must not be
+ * interrupted by rtimer_run_next(): call them from a real-time task,
+ * or with the real-time timer interrupt disabled.
+ */
+#ifdef RTIMER_CONF_MULTIPLE
+#define RTIMER_MULTIPLE RTIMER_CONF_MULTIPLE
+#else /* RTIMER_CONF_MULTIPLE */
+#define RTIMER_MULTIPLE 0
+#endif /* RTIMER_CONF_MULTIPLE */
+
+#ifdef RTIMER_CONF_QUEUE_SIZE
+#define RTIMER_QUEUE_SIZE RTIMER_CONF_QUEUE_SIZE
+#else /* RTIMER_CONF_QUEUE_SIZE */
+#define RTIMER_QUEUE_SIZE 8
+#endif /* RTIMER_CONF_QUEUE_SIZE */
+
+/* Task priorities; lower values run first */
+#define RTIMER_PRIORITY_MAC     0
+#define RTIMER_PRIORITY_DEFAULT 1
+
+/* Collect statistics on how late real-time tasks run */
+#ifdef RTIMER_CONF_STATS
+#define RTIMER_STATS RTIMER_CONF_STATS
+#else /* RTIMER_CONF_STATS */
+#define RTIMER_STATS 0
+#endif /* RTIMER_CONF_STATS */
+
+#if RTIMER_STATS
+/* Number of bins in the lateness histogram. Bin 0 counts tasks that
+   ran on time, bin i counts tasks that were between 2^(i-1) and
+   2^i - 1 ticks late, and the last bin also counts anything later. */
+#define RTIMER_STATS_BINS 12
+
+struct rtimer_stats {
+  unsigned long scheduled;
+  unsigned long full;
+  unsigned long fired;
+  rtimer_clock_t max_lateness;
+  unsigned long lateness[RTIMER_STATS_BINS];
+};
+
+extern struct rtimer_stats rtimer_stats;
+#endif /* RTIMER_STATS */
+
 /**
  * \brief      Representation of a real-time task
  *
@@ -87,6 +138,10 @@ struct rtimer {
   rtimer_clock_t time;
   rtimer_callback_t func;
   void *ptr;
+#if RTIMER_MULTIPLE
+  uint8_t index;
+  uint8_t priority;
+#endif /* RTIMER_MULTIPLE */
 };
 
 enum {
@@ -113,6 +168,35 @@ enum {
 int rtimer_set(struct rtimer *task, rtimer_clock_t time,
 	       rtimer_clock_t duration, rtimer_callback_t func, void *ptr);
 
+/**
+ * \brief      Post a real-time task with a priority.
+ * \param task A pointer to the task variable previously declared with RTIMER_TASK().
+ * \param time The time when the task is to be executed.
+ * \param func A function to be called when the task is executed.
+ * \param ptr An opaque pointer that will be supplied as an argument to the callback function.
+ * \param priority RTIMER_PRIORITY_MAC for tasks that must run before
+ *             any other task due at the same time, or
+ *             RTIMER_PRIORITY_DEFAULT.
+ * \return     RTIMER_OK if the task could be scheduled, or
+ *             RTIMER_ERR_FULL if the task queue is full.
+ *
+ *             The priority is only used with RTIMER_CONF_MULTIPLE.
+ *             If the task is already pending, it is moved to the
+ *             new time.
+ */
+int rtimer_set_with_priority(struct rtimer *task, rtimer_clock_t time,
+                             rtimer_callback_t func, void *ptr,
+                             uint8_t priority);
+
+/**
+ * \brief      Remove a pending real-time task.
+ * \param task A pointer to the task
+ *
+ *             The task will not be executed. Nothing happens if the
+ *             task is not pending.
+ */
+void rtimer_stop(struct rtimer *task);
+
 /**
  * \brief      Execute the next real-time task and schedule the next task, if any
  *
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         A radio medium shared by many native nodes.
+ *
+ *         Each node is a process of its own, so every node has its own
+ *         copy of the Contiki state. The nodes share one memory
+ *         mapping that holds a bounded inbox per node. Any neighbour
+ *         may add frames to an inbox without locking, and only the
+ *         owning node removes them. A node is woken up with SIGUSR1
+ *         when frames arrive while it is not already draining its
+ *         inbox.
+ */
+
+#include "contiki.h"
+
+#if defined(linux) && defined(MULTINODE_CONF_NODES)
+
+#include "multinode-radio.h"
+
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#ifdef MULTINODE_CONF_RANGE
+#define MULTINODE_RANGE MULTINODE_CONF_RANGE
+#else
+#define MULTINODE_RANGE 1
+#endif
+
+/* Must be a power of two */
+#ifdef MULTINODE_CONF_INBOX_SIZE
+#define MULTINODE_INBOX_SIZE MULTINODE_CONF_INBOX_SIZE
+#else
+#define MULTINODE_INBOX_SIZE 16
+#endif
+
+#define MAX_FRAME_SIZE 127
+
+struct frame {
+  /* Equal to the position in the inbox when the slot is free, and to
+     the position plus one once a frame has been written to it. */
+  uint32_t seq;
+  uint8_t len;
+  uint8_t data[MAX_FRAME_SIZE];
+};
+
+struct inbox {
+  uint32_t head;      /* Next position to claim, shared by senders */
+  uint32_t tail;      /* Next position to read, owned by the node */
+  uint32_t signalled; /* Non-zero if the node has been signalled */
+  uint32_t received;
+  uint32_t dropped;
+  pid_t pid;
+  struct frame slots[MULTINODE_INBOX_SIZE];
+};
+
+static struct inbox *inboxes;
+static int num_nodes;
+static int width;
+static int self;
+
+static sigset_t wait_sigmask;
+static uint8_t tx_buf[MAX_FRAME_SIZE];
+static uint8_t tx_len;
+
+PROCESS(multinode_radio_process, "Multi-node radio");
+/*---------------------------------------------------------------------------*/
+static void
+notify(int sig)
+{
+  process_poll(&multinode_radio_process);
+}
+/*---------------------------------------------------------------------------*/
+static int
+enqueue(struct inbox *in, const uint8_t *data, uint8_t len)
+{
+  struct frame *f;
+  uint32_t pos;
+  int32_t diff;
+
+  pos = __atomic_load_n(&in->head, __ATOMIC_RELAXED);
+  while(1) {
+    f = &in->slots[pos & (MULTINODE_INBOX_SIZE - 1)];
+    diff = (int32_t)(__atomic_load_n(&f->seq, __ATOMIC_ACQUIRE) - pos);
+    if(diff == 0) {
+      if(__atomic_compare_exchange_n(&in->head, &pos, pos + 1, 0,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        break;
+      }
+    } else if(diff < 0) {
+      /* The inbox is full */
+      __atomic_fetch_add(&in->dropped, 1, __ATOMIC_RELAXED);
+      return 0;
+    } else {
+      pos = __atomic_load_n(&in->head, __ATOMIC_RELAXED);
+    }
+  }
+
+  memcpy(f->data, data, len);
+  f->len = len;
+  __atomic_store_n(&f->seq, pos + 1, __ATOMIC_RELEASE);
+
+  if(!__atomic_exchange_n(&in->signalled, 1, __ATOMIC_SEQ_CST)) {
+    kill(__atomic_load_n(&in->pid, __ATOMIC_SEQ_CST), SIGUSR1);
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+drain(void)
+{
+  struct inbox *in = &inboxes[self];
+  struct frame *f;
+
+  /* Clear the flag first, so that frames added after the inbox has
+     been found empty cause a new notification. */
+  __atomic_store_n(&in->signalled, 0, __ATOMIC_SEQ_CST);
+
+  while(1) {
+    f = &in->slots[in->tail & (MULTINODE_INBOX_SIZE - 1)];
+    if(__atomic_load_n(&f->seq, __ATOMIC_ACQUIRE) != in->tail + 1) {
+      break;
+    }
+    packetbuf_clear();
+    memcpy(packetbuf_dataptr(), f->data, f->len);
+    packetbuf_set_datalen(f->len);
+    __atomic_store_n(&f->seq, in->tail + MULTINODE_INBOX_SIZE,
+                     __ATOMIC_RELEASE);
+    in->tail++;
+    in->received++;
+    NETSTACK_RDC.input();
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(multinode_radio_process, ev, data)
+{
+  PROCESS_POLLHANDLER(drain());
+
+  PROCESS_BEGIN();
+
+  PROCESS_WAIT_UNTIL(ev == PROCESS_EVENT_EXIT);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static int
+init(void)
+{
+  signal(SIGUSR1, notify);
+  process_start(&multinode_radio_process, NULL);
+  process_poll(&multinode_radio_process);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+prepare(const void *payload, unsigned short payload_len)
+{
+  if(payload_len > MAX_FRAME_SIZE) {
+    return 1;
+  }
+  memcpy(tx_buf, payload, payload_len);
+  tx_len = payload_len;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+transmit(unsigned short transmit_len)
+{
+  int x, y;
+  int dx, dy;
+  int n;
+
+  x = self % width;
+  y = self / width;
+  for(dy = -MULTINODE_RANGE; dy <= MULTINODE_RANGE; dy++) {
+    for(dx = -MULTINODE_RANGE; dx <= MULTINODE_RANGE; dx++) {
+      n = (y + dy) * width + x + dx;
+      if((dx != 0 || dy != 0) &&
+         x + dx >= 0 && x + dx < width && y + dy >= 0 && n < num_nodes) {
+        enqueue(&inboxes[n], tx_buf, tx_len);
+      }
+    }
+  }
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send(const void *payload, unsigned short payload_len)
+{
+  if(prepare(payload, payload_len)) {
+    return RADIO_TX_ERR;
+  }
+  return transmit(payload_len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_read(void *buf, unsigned short buf_len)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+channel_clear(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+receiving_packet(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+pending_packet(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_value(radio_param_t param, radio_value_t *value)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_value(radio_param_t param, radio_value_t value)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_object(radio_param_t param, void *dest, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_driver multinode_radio_driver = {
+  init,
+  prepare,
+  transmit,
+  send,
+  radio_read,
+  channel_clear,
+  receiving_packet,
+  pending_packet,
+  on,
+  off,
+  get_value,
+  set_value,
+  get_object,
+  set_object
+};
+/*---------------------------------------------------------------------------*/
+int
+multinode_start(void)
+{
+  sigset_t block;
+  char *env;
+  pid_t pid;
+  int status;
+  int i, j;
+
+  num_nodes = MULTINODE_CONF_NODES;
+  env = getenv("MULTINODE_NODES");
+  if(env != NULL) {
+    num_nodes = atoi(env);
+  }
+  if(num_nodes < 1) {
+    num_nodes = 1;
+  }
+  for(width = 1; width * width < num_nodes; width++);
+
+  inboxes = mmap(NULL, num_nodes * sizeof(struct inbox),
+                 PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if(inboxes == MAP_FAILED) {
+    perror("multinode: mmap");
+    exit(1);
+  }
+  for(i = 0; i < num_nodes; i++) {
+    for(j = 0; j < MULTINODE_INBOX_SIZE; j++) {
+      inboxes[i].slots[j].seq = j;
+    }
+  }
+
+  /* Only let notifications in while waiting for events, see
+     multinode_sigmask(). */
+  sigemptyset(&block);
+  sigaddset(&block, SIGUSR1);
+  sigprocmask(SIG_BLOCK, &block, &wait_sigmask);
+  sigdelset(&wait_sigmask, SIGUSR1);
+
+  for(i = 0; i < num_nodes; i++) {
+    /* Until the node has started, notifications go to the parent,
+       which never takes them. The node drains its inbox once when
+       its radio is initialized, so no frames are stranded. */
+    inboxes[i].pid = getpid();
+    pid = fork();
+    if(pid < 0) {
+      perror("multinode: fork");
+      exit(1);
+    }
+    if(pid == 0) {
+      prctl(PR_SET_PDEATHSIG, SIGTERM);
+      self = i;
+      __atomic_store_n(&inboxes[i].pid, getpid(), __ATOMIC_SEQ_CST);
+      return i + 1;
+    }
+  }
+
+  printf("multinode: started %d nodes on a %dx%d grid\n",
+         num_nodes, width, (num_nodes + width - 1) / width);
+
+  while(wait(&status) > 0);
+
+  for(i = 0; i < num_nodes; i++) {
+    if(inboxes[i].dropped > 0) {
+      printf("multinode: node %d received %u frames, dropped %u\n",
+             i + 1, inboxes[i].received, inboxes[i].dropped);
+    }
+  }
+  exit(0);
+}
+/*---------------------------------------------------------------------------*/
+const sigset_t *
+multinode_sigmask(void)
+{
+  return &wait_sigmask;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* linux && MULTINODE_CONF_NODES */
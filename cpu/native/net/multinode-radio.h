@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         A radio medium shared by many native nodes in one process
+ *         tree. multinode_start() forks the nodes, which then exchange
+ *         frames through per-node inboxes in shared memory.
+ */
+
+#ifndef MULTINODE_RADIO_H_
+#define MULTINODE_RADIO_H_
+
+#include <signal.h>
+
+#include "dev/radio.h"
+
+extern const struct radio_driver multinode_radio_driver;
+
+/**
+ * \brief      Fork the nodes of a multi-node run.
+ * \return     The id of the calling node, from 1 up to the number of
+ *             nodes. The parent process does not return, but waits
+ *             for all nodes to exit and then exits itself.
+ *
+ *             The number of nodes is taken from the MULTINODE_NODES
+ *             environment variable, or from MULTINODE_CONF_NODES.
+ *             Nodes are laid out on a square grid and hear the nodes
+ *             that are at most MULTINODE_CONF_RANGE steps away.
+ */
+int multinode_start(void);
+
+/**
+ * \brief      Get the signal mask to wait for events with.
+ * \return     The signal mask to pass to pselect() or epoll_pwait()
+ *
+ *             Frame notifications are blocked outside of these calls,
+ *             so that one arriving just before the main loop goes to
+ *             sleep is not lost.
+ */
+const sigset_t *multinode_sigmask(void);
+
+#endif /* MULTINODE_RADIO_H_ */
@@ -61,6 +61,19 @@ tapdev_output(void)
 static void
 pollhandler(void)
 {
+#if NETSTACK_CONF_WITH_IPV6 && TCPIP_INPUT_QUEUE
+  uint8_t *buf;
+  int len;
+
+  /* Queue all the frames waiting on the device, as long as the stack
+     has room for them */
+  while((buf = tcpip_input_get_buf()) != NULL &&
+        (len = tapdev_poll_buf(buf)) > 0) {
+    if(((struct uip_eth_hdr *)buf)->type == uip_htons(UIP_ETHTYPE_IPV6)) {
+      tcpip_input_put_buf(len);
+    }
+  }
+#else /* NETSTACK_CONF_WITH_IPV6 && TCPIP_INPUT_QUEUE */
   uip_len = tapdev_poll();
 
   if(uip_len > 0) {
@@ -86,6 +99,7 @@ pollhandler(void)
       uip_clear_buf();
     }
   }
+#endif /* NETSTACK_CONF_WITH_IPV6 && TCPIP_INPUT_QUEUE */
 }
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(tapdev_process, ev, data)
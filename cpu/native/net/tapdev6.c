@@ -108,8 +108,8 @@ tapdev_fd(void)
 }
 
 
-uint16_t
-tapdev_poll(void)
+int
+tapdev_poll_buf(uint8_t *buf)
 {
   fd_set fdset;
   struct timeval tv;
@@ -128,7 +128,7 @@ tapdev_poll(void)
   if(ret == 0) {
     return 0;
   }
-  ret = read(fd, uip_buf, UIP_BUFSIZE);
+  ret = read(fd, buf, UIP_BUFSIZE);
 
   PRINTF("tapdev6: read %d bytes (max %d)\n", ret, UIP_BUFSIZE);
   
@@ -138,6 +138,12 @@ tapdev_poll(void)
   return ret;
 }
 /*---------------------------------------------------------------------------*/
+uint16_t
+tapdev_poll(void)
+{
+  return tapdev_poll_buf(uip_buf);
+}
+/*---------------------------------------------------------------------------*/
 #if defined(__APPLE__)
 static int reqfd = -1, sfd = -1, interface_index;
 
@@ -41,6 +41,8 @@
 void tapdev_init(void);
 uint8_t tapdev_send(const uip_lladdr_t *lladdr);
 uint16_t tapdev_poll(void);
+/* Read a frame into buf, UIP_BUFSIZE bytes long, if one is waiting */
+int tapdev_poll_buf(uint8_t *buf);
 void tapdev_do_send(void);
 void tapdev_exit(void); //math
 #endif /* TAPDEV_H_ */
@@ -54,6 +54,50 @@
 #define PRINTF(...)
 #endif
 
+#if CLOCK_VIRTUAL
+/*
+ * There is no timer signal in virtual time. The main loop asks for
+ * the scheduled time with rtimer_arch_next() and runs the rtimer
+ * itself once the clock has got there.
+ */
+static int scheduled;
+static rtimer_clock_t deadline;
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_init(void)
+{
+  scheduled = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_schedule(rtimer_clock_t t)
+{
+  deadline = t;
+  scheduled = 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_arch_next(clock_time_t *when)
+{
+  clock_time_t now;
+  short diff;
+
+  if(!scheduled) {
+    return 0;
+  }
+  now = clock_time();
+  diff = (short)(deadline - (rtimer_clock_t)now);
+  *when = diff > 0 ? now + diff : now;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_run(void)
+{
+  scheduled = 0;
+  rtimer_run_next();
+}
+#else /* CLOCK_VIRTUAL */
 /*---------------------------------------------------------------------------*/
 static void
 interrupt(int sig)
@@ -89,4 +133,5 @@ rtimer_arch_schedule(rtimer_clock_t t)
   setitimer(ITIMER_REAL, &val, NULL);
 #endif /* !_WIN32 */
 }
+#endif /* CLOCK_VIRTUAL */
 /*---------------------------------------------------------------------------*/
@@ -41,9 +41,25 @@
 #define RTIMER_ARCH_H_
 
 #include "contiki-conf.h"
+#include "sys/clock.h"
 
 #define RTIMER_ARCH_SECOND CLOCK_CONF_SECOND
 
 #define rtimer_arch_now() clock_time()
 
+#if CLOCK_VIRTUAL
+/**
+ * \brief      Get the time of the scheduled rtimer in virtual time.
+ * \param when Set to the clock time at which the rtimer is due
+ * \return     Non-zero if an rtimer is scheduled
+ */
+int rtimer_arch_next(clock_time_t *when);
+
+/**
+ * \brief      Run the scheduled rtimer, on behalf of the missing
+ *             timer interrupt.
+ */
+void rtimer_arch_run(void);
+#endif /* CLOCK_VIRTUAL */
+
 #endif /* RTIMER_ARCH_H_ */
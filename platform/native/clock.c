@@ -41,6 +41,27 @@
 #include <time.h>
 #include <sys/time.h>
 
+#if CLOCK_VIRTUAL
+static clock_time_t now;
+/*---------------------------------------------------------------------------*/
+clock_time_t
+clock_time(void)
+{
+  return now;
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+clock_seconds(void)
+{
+  return now / CLOCK_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+void
+clock_set_virtual(clock_time_t t)
+{
+  now = t;
+}
+#else /* CLOCK_VIRTUAL */
 /*---------------------------------------------------------------------------*/
 clock_time_t
 clock_time(void)
@@ -61,6 +82,7 @@ clock_seconds(void)
 
   return tv.tv_sec;
 }
+#endif /* CLOCK_VIRTUAL */
 /*---------------------------------------------------------------------------*/
 void
 clock_delay(unsigned int d)
@@ -73,6 +73,9 @@ typedef unsigned short uip_stats_t;
 #define UIP_CONF_TCP_SPLIT       0
 #define UIP_CONF_LOGGING         0
 #define UIP_CONF_UDP_CHECKSUMS   1
+#ifndef UIP_CONF_CHKSUM_WIDE
+#define UIP_CONF_CHKSUM_WIDE     1
+#endif /* UIP_CONF_CHKSUM_WIDE */
 
 #ifndef NETSTACK_CONF_RDC_CHANNEL_CHECK_RATE
 #define NETSTACK_CONF_RDC_CHANNEL_CHECK_RATE 8
@@ -91,7 +94,11 @@ typedef unsigned short uip_stats_t;
 #endif /* NETSTACK_CONF_RDC */
 
 #ifndef NETSTACK_CONF_RADIO
+#ifdef MULTINODE_CONF_NODES
+#define NETSTACK_CONF_RADIO   multinode_radio_driver
+#else
 #define NETSTACK_CONF_RADIO   nullradio_driver
+#endif
 #endif /* NETSTACK_CONF_RADIO */
 
 #ifndef NETSTACK_CONF_FRAMER
@@ -234,6 +241,19 @@ typedef unsigned long clock_time_t;
 
 #define CLOCK_CONF_SECOND 1000
 
+/* With CLOCK_CONF_VIRTUAL, time stands still while there is work to
+   do, and the main loop moves it straight to the next timer deadline
+   when there is none. */
+#ifdef CLOCK_CONF_VIRTUAL
+#define CLOCK_VIRTUAL CLOCK_CONF_VIRTUAL
+#else
+#define CLOCK_VIRTUAL 0
+#endif
+
+#if CLOCK_VIRTUAL
+void clock_set_virtual(clock_time_t t);
+#endif /* CLOCK_VIRTUAL */
+
 #define LOG_CONF_ENABLED 1
 
 #define PROGRAM_HANDLER_CONF_MAX_NUMDSCS 10
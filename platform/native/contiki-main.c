@@ -45,8 +45,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <stdlib.h>
 #include <sys/select.h>
 #include <errno.h>
+#include <time.h>
 
 #ifdef __CYGWIN__
 #include "net/wpcap-drv.h"
@@ -59,6 +61,7 @@
 #include "ctk/ctk-curses.h"
 
 #include "dev/serial-line.h"
+#include "lib/random.h"
 
 #include "net/ip/uip.h"
 
@@ -72,8 +75,51 @@
 
 #include "net/rime/rime.h"
 
+#ifdef MULTINODE_CONF_NODES
+#include "net/multinode-radio.h"
+#define WAIT_SIGMASK multinode_sigmask()
+#else
+#define WAIT_SIGMASK NULL
+#endif /* MULTINODE_CONF_NODES */
+
+/*
+ * SELECT_CONF_EPOLL waits for the descriptors with epoll instead of
+ * select, so that only the callbacks of ready descriptors are run and
+ * descriptors beyond the first few can be used. The callbacks are
+ * expected to set only the descriptor they were registered for.
+ *
+ * SELECT_CONF_TICKLESS makes the main loop sleep until the next etimer
+ * expires, or until a descriptor becomes ready, instead of waking up
+ * every millisecond.
+ *
+ * SELECT_CONF_STATS prints the number of wakeups per second, the time
+ * spent handling each wakeup and how late timer wakeups are, every
+ * SELECT_STATS_INTERVAL seconds.
+ */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL SELECT_CONF_EPOLL
+#else
+#define SELECT_EPOLL 0
+#endif
+
+#ifdef SELECT_CONF_TICKLESS
+#define SELECT_TICKLESS SELECT_CONF_TICKLESS
+#else
+#define SELECT_TICKLESS 0
+#endif
+
+#ifdef SELECT_CONF_STATS
+#define SELECT_STATS SELECT_CONF_STATS
+#else
+#define SELECT_STATS 0
+#endif
+
+#define SELECT_STATS_INTERVAL 10
+
 #ifdef SELECT_CONF_MAX
 #define SELECT_MAX SELECT_CONF_MAX
+#elif SELECT_EPOLL
+#define SELECT_MAX FD_SETSIZE
 #else
 #define SELECT_MAX 8
 #endif
@@ -81,6 +127,34 @@
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
 
+#if SELECT_EPOLL
+#include <sys/epoll.h>
+
+#define EPOLL_MAX_EVENTS 16
+
+static int epoll_fd = -1;
+/* The registered descriptors, and what epoll is watching them for */
+static int select_fds[SELECT_MAX];
+static int select_nfds;
+static uint32_t select_events[SELECT_MAX];
+/* Regular files cannot be watched by epoll, but are always ready */
+static uint8_t select_regular[SELECT_MAX];
+#endif /* SELECT_EPOLL */
+
+#if SELECT_STATS
+static struct {
+  uint64_t start;
+  uint64_t sleep;
+  uint64_t deadline;
+  unsigned long wakeups;
+  unsigned long timeouts;
+  uint64_t busy;
+  uint64_t busy_max;
+  uint64_t late;
+  uint64_t late_max;
+} loop_stats;
+#endif /* SELECT_STATS */
+
 SENSORS(&pir_sensor, &vib_sensor, &button_sensor);
 
 static uint8_t serial_id[] = {0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08};
@@ -99,6 +173,20 @@ select_set_callback(int fd, const struct select_callback *callback)
       callback = NULL;
     }
 
+#if SELECT_EPOLL
+    if(callback != NULL && select_callback[fd] == NULL) {
+      select_fds[select_nfds++] = fd;
+    } else if(callback == NULL && select_callback[fd] != NULL) {
+      for(i = 0; select_fds[i] != fd; i++);
+      select_fds[i] = select_fds[--select_nfds];
+      if(select_events[fd] != 0 && !select_regular[fd]) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+      }
+      select_events[fd] = 0;
+      select_regular[fd] = 0;
+    }
+#endif /* SELECT_EPOLL */
+
     select_callback[fd] = callback;
 
     /* Update fd max */
@@ -130,9 +218,14 @@ static void
 stdin_handle_fd(fd_set *rset, fd_set *wset)
 {
   char c;
+  int n;
   if(FD_ISSET(STDIN_FILENO, rset)) {
-    if(read(STDIN_FILENO, &c, 1) > 0) {
+    n = read(STDIN_FILENO, &c, 1);
+    if(n > 0) {
       serial_line_input_byte(c);
+    } else if(n == 0 && !isatty(STDIN_FILENO)) {
+      /* End of a redirected input: stop waking up for it */
+      select_set_callback(STDIN_FILENO, NULL);
     }
   }
 }
@@ -140,6 +233,307 @@ const static struct select_callback stdin_fd = {
   stdin_set_fd, stdin_handle_fd
 };
 /*---------------------------------------------------------------------------*/
+#if SELECT_STATS
+static uint64_t
+monotonic_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+/*---------------------------------------------------------------------------*/
+static void
+stats_sleep(long timeout)
+{
+  uint64_t now;
+  uint64_t busy;
+
+  now = monotonic_us();
+  if(loop_stats.start == 0) {
+    loop_stats.start = now;
+  } else {
+    busy = now - loop_stats.sleep;
+    loop_stats.busy += busy;
+    if(busy > loop_stats.busy_max) {
+      loop_stats.busy_max = busy;
+    }
+  }
+  loop_stats.deadline = timeout <= 0 ? 0 : now + timeout;
+}
+/*---------------------------------------------------------------------------*/
+static void
+stats_wakeup(int timed_out)
+{
+  uint64_t now;
+  uint64_t late;
+  unsigned long seconds;
+
+  now = monotonic_us();
+  loop_stats.sleep = now;
+  loop_stats.wakeups++;
+  if(timed_out && loop_stats.deadline != 0) {
+    late = now > loop_stats.deadline ? now - loop_stats.deadline : 0;
+    loop_stats.timeouts++;
+    loop_stats.late += late;
+    if(late > loop_stats.late_max) {
+      loop_stats.late_max = late;
+    }
+  }
+
+  seconds = (now - loop_stats.start) / 1000000;
+  if(seconds >= SELECT_STATS_INTERVAL) {
+    fprintf(stderr, "select: %lu wakeups/s, busy avg %lu max %lu us, "
+            "timer late avg %lu max %lu us\n",
+            loop_stats.wakeups / seconds,
+            (unsigned long)(loop_stats.busy / loop_stats.wakeups),
+            (unsigned long)loop_stats.busy_max,
+            (unsigned long)(loop_stats.timeouts ?
+                            loop_stats.late / loop_stats.timeouts : 0),
+            (unsigned long)loop_stats.late_max);
+    memset(&loop_stats, 0, sizeof(loop_stats));
+    loop_stats.start = now;
+    loop_stats.sleep = now;
+  }
+}
+#endif /* SELECT_STATS */
+/*---------------------------------------------------------------------------*/
+/* How long to wait for the descriptors, in microseconds, or -1 to wait
+   until one of them is ready. */
+static long
+select_timeout(int pending)
+{
+#if CLOCK_VIRTUAL
+  /* Timers are taken care of by virtual_time_advance() */
+  return pending ? 0 : -1;
+#elif SELECT_TICKLESS
+  long ticks;
+
+  if(pending) {
+    return 0;
+  }
+  if(!etimer_pending()) {
+    return -1;
+  }
+  ticks = (long)(etimer_next_expiration_time() - clock_time());
+  if(ticks <= 0) {
+    return 0;
+  }
+  if(ticks > 60 * CLOCK_SECOND) {
+    ticks = 60 * CLOCK_SECOND;
+  }
+  return ticks * (1000000 / CLOCK_SECOND);
+#else /* SELECT_TICKLESS */
+  return pending ? 1 : 1000;
+#endif /* SELECT_TICKLESS */
+}
+/*---------------------------------------------------------------------------*/
+#if CLOCK_VIRTUAL
+/*
+ * Runs the rtimer if it is due, and, if the system is idle, moves the
+ * clock to the next etimer or rtimer deadline. Returns non-zero if
+ * there is something to do at the new time.
+ *
+ * The run ends once the clock passes CONTIKI_DURATION seconds, if that
+ * environment variable is set.
+ */
+static int
+virtual_time_advance(int idle)
+{
+  static clock_time_t end;
+  clock_time_t now;
+  clock_time_t next;
+  int rtimer_due;
+  char *env;
+
+  if(end == 0) {
+    env = getenv("CONTIKI_DURATION");
+    end = env != NULL ?
+      strtoul(env, NULL, 0) * CLOCK_SECOND : (clock_time_t)-1;
+  }
+
+  now = clock_time();
+  rtimer_due = rtimer_arch_next(&next) &&
+    (next == now ||
+     (idle && (!etimer_pending() ||
+               (long)(next - etimer_next_expiration_time()) <= 0)));
+  if(!rtimer_due) {
+    if(!idle || !etimer_pending()) {
+      return 0;
+    }
+    next = etimer_next_expiration_time();
+    if((long)(next - now) < 0) {
+      next = now;
+    }
+  }
+
+  clock_set_virtual(next);
+  if(next >= end) {
+    printf("Virtual time is up after %lu seconds\n", clock_seconds());
+    exit(0);
+  }
+  if(rtimer_due) {
+    rtimer_arch_run();
+  }
+  return 1;
+}
+#endif /* CLOCK_VIRTUAL */
+/*---------------------------------------------------------------------------*/
+#if SELECT_EPOLL
+static void
+select_wait(long timeout)
+{
+  struct epoll_event events[EPOLL_MAX_EVENTS];
+  struct epoll_event ev;
+  fd_set fdr;
+  fd_set fdw;
+  int regular[EPOLL_MAX_EVENTS / 2];
+  int nregular;
+  uint32_t want;
+  int fd;
+  int i;
+  int n;
+
+  if(epoll_fd < 0) {
+    epoll_fd = epoll_create1(0);
+    if(epoll_fd < 0) {
+      perror("epoll_create1");
+      exit(1);
+    }
+  }
+
+  /* Ask the callbacks what they are interested in, and update epoll
+     for the descriptors whose interest has changed. */
+  FD_ZERO(&fdr);
+  FD_ZERO(&fdw);
+  for(i = 0; i < select_nfds; i++) {
+    select_callback[select_fds[i]]->set_fd(&fdr, &fdw);
+  }
+  nregular = 0;
+  for(i = 0; i < select_nfds; i++) {
+    fd = select_fds[i];
+    want = (FD_ISSET(fd, &fdr) ? EPOLLIN : 0) |
+      (FD_ISSET(fd, &fdw) ? EPOLLOUT : 0);
+    if(select_regular[fd]) {
+      if(want != 0 && nregular < EPOLL_MAX_EVENTS / 2) {
+        regular[nregular++] = fd;
+      }
+      select_events[fd] = want;
+      continue;
+    }
+    if(want == select_events[fd]) {
+      continue;
+    }
+    ev.events = want;
+    ev.data.fd = fd;
+    if(want == 0) {
+      epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    } else if(select_events[fd] == 0 ||
+              (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0 &&
+               errno == ENOENT)) {
+      /* epoll forgets descriptors that have been closed and reopened */
+      if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        if(errno == EPERM) {
+          select_regular[fd] = 1;
+          if(nregular < EPOLL_MAX_EVENTS / 2) {
+            regular[nregular++] = fd;
+          }
+        } else {
+          perror("epoll_ctl");
+          want = 0;
+        }
+      }
+    }
+    select_events[fd] = want;
+  }
+  if(nregular > 0) {
+    timeout = 0;
+  }
+
+#if SELECT_STATS
+  stats_sleep(timeout);
+#endif /* SELECT_STATS */
+  n = epoll_pwait(epoll_fd, events, EPOLL_MAX_EVENTS - nregular,
+                  timeout < 0 ? -1 : (int)(timeout / 1000), WAIT_SIGMASK);
+#if SELECT_STATS
+  stats_wakeup(n == 0);
+#endif /* SELECT_STATS */
+  if(n < 0) {
+    if(errno != EINTR) {
+      perror("epoll_pwait");
+    }
+    n = 0;
+  }
+
+  /* The regular files are handled as if epoll had reported them */
+  for(i = 0; i < nregular; i++) {
+    events[n].events = select_events[regular[i]];
+    events[n++].data.fd = regular[i];
+  }
+
+  FD_ZERO(&fdr);
+  FD_ZERO(&fdw);
+  for(i = 0; i < n; i++) {
+    if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+      FD_SET(events[i].data.fd, &fdr);
+    }
+    if(events[i].events & EPOLLOUT) {
+      FD_SET(events[i].data.fd, &fdw);
+    }
+  }
+  for(i = 0; i < n; i++) {
+    fd = events[i].data.fd;
+    if(select_callback[fd] != NULL) {
+      select_callback[fd]->handle_fd(&fdr, &fdw);
+    }
+  }
+}
+#else /* SELECT_EPOLL */
+static void
+select_wait(long timeout)
+{
+  fd_set fdr;
+  fd_set fdw;
+  int maxfd;
+  int i;
+  int retval;
+  struct timespec ts;
+
+  ts.tv_sec = timeout / 1000000;
+  ts.tv_nsec = (timeout % 1000000) * 1000;
+
+  FD_ZERO(&fdr);
+  FD_ZERO(&fdw);
+  maxfd = 0;
+  for(i = 0; i <= select_max; i++) {
+    if(select_callback[i] != NULL && select_callback[i]->set_fd(&fdr, &fdw)) {
+      maxfd = i;
+    }
+  }
+
+#if SELECT_STATS
+  stats_sleep(timeout);
+#endif /* SELECT_STATS */
+  retval = pselect(maxfd + 1, &fdr, &fdw, NULL, timeout < 0 ? NULL : &ts,
+                   WAIT_SIGMASK);
+#if SELECT_STATS
+  stats_wakeup(retval == 0);
+#endif /* SELECT_STATS */
+  if(retval < 0) {
+    if(errno != EINTR) {
+      perror("pselect");
+    }
+  } else if(retval > 0) {
+    /* timeout => retval == 0 */
+    for(i = 0; i <= maxfd; i++) {
+      if(select_callback[i] != NULL) {
+        select_callback[i]->handle_fd(&fdr, &fdw);
+      }
+    }
+  }
+}
+#endif /* SELECT_EPOLL */
+/*---------------------------------------------------------------------------*/
 static void
 set_rime_addr(void)
 {
@@ -201,6 +595,26 @@ main(int argc, char **argv)
 #endif
 #endif
 
+#ifdef MULTINODE_CONF_NODES
+  {
+    /* Give every node its own link-layer address */
+    int node = multinode_start();
+    serial_id[6] = node >> 8;
+    serial_id[7] = node & 0xff;
+#if !NETSTACK_CONF_WITH_IPV6
+    node_id = node;
+#endif /* !NETSTACK_CONF_WITH_IPV6 */
+  }
+#endif /* MULTINODE_CONF_NODES */
+
+#if CLOCK_VIRTUAL
+  {
+    /* Runs with the same seed behave the same */
+    char *seed = getenv("CONTIKI_SEED");
+    random_init(seed != NULL ? strtoul(seed, NULL, 0) : 0);
+  }
+#endif /* CLOCK_VIRTUAL */
+
   process_init();
   process_start(&etimer_process, NULL);
   ctimer_init();
@@ -251,40 +665,16 @@ main(int argc, char **argv)
 
   select_set_callback(STDIN_FILENO, &stdin_fd);
   while(1) {
-    fd_set fdr;
-    fd_set fdw;
-    int maxfd;
-    int i;
     int retval;
-    struct timeval tv;
 
     retval = process_run();
-
-    tv.tv_sec = 0;
-    tv.tv_usec = retval ? 1 : 1000;
-
-    FD_ZERO(&fdr);
-    FD_ZERO(&fdw);
-    maxfd = 0;
-    for(i = 0; i <= select_max; i++) {
-      if(select_callback[i] != NULL && select_callback[i]->set_fd(&fdr, &fdw)) {
-        maxfd = i;
-      }
+#if CLOCK_VIRTUAL
+    if(virtual_time_advance(retval == 0)) {
+      retval = 1;
     }
+#endif /* CLOCK_VIRTUAL */
 
-    retval = select(maxfd + 1, &fdr, &fdw, NULL, &tv);
-    if(retval < 0) {
-      if(errno != EINTR) {
-        perror("select");
-      }
-    } else if(retval > 0) {
-      /* timeout => retval == 0 */
-      for(i = 0; i <= maxfd; i++) {
-        if(select_callback[i] != NULL) {
-          select_callback[i]->handle_fd(&fdr, &fdw);
-        }
-      }
-    }
+    select_wait(select_timeout(retval));
 
     etimer_request_poll();
 
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Internet checksum benchmark: the throughput of summing
+ *         packets of different sizes, and the cost of updating a
+ *         checksum after rewriting addresses and a port, as in
+ *         address translation, compared with summing the packet again.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ip/uip-chksum.h"
+#include "lib/random.h"
+
+#include "bench.h"
+
+#define ROUNDS 100000
+#define CHECKS 10000
+#define MAX_SIZE 1500
+#define ADDRS_LEN 32
+
+/* Where the rewritten fields are in the packets */
+#define CHKSUM_OFFSET 0
+#define PORT_OFFSET 2
+#define ADDRS_OFFSET 4
+
+PROCESS(bench_process, "chksum benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+static uint8_t packet[MAX_SIZE + 8];
+static uint8_t addrs[ADDRS_LEN];
+static const unsigned long sizes[] = { 20, 64, 128, 1280 };
+/*---------------------------------------------------------------------------*/
+/* The original 16 bits at a time sum, as a reference */
+static uint16_t
+ref_chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  uint16_t i;
+
+  for(i = 0; i + 1 < len; i += 2) {
+    t = (data[i] << 8) + data[i + 1];
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+  if(i < len) {
+    t = data[i] << 8;
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+static void
+random_data(uint8_t *data, uint16_t len)
+{
+  uint16_t i;
+
+  for(i = 0; i < len; i++) {
+    data[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+get16(int offset)
+{
+  return (packet[offset] << 8) | packet[offset + 1];
+}
+/*---------------------------------------------------------------------------*/
+static void
+set16(int offset, uint16_t val)
+{
+  packet[offset] = val >> 8;
+  packet[offset + 1] = val & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+/* Rewrite the port and addresses of the packet and update its checksum */
+static void
+rewrite(uint16_t port)
+{
+  uint16_t chksum;
+
+  chksum = uip_chksum_update(get16(CHKSUM_OFFSET),
+                             uip_chksum_add(0, &packet[ADDRS_OFFSET], ADDRS_LEN),
+                             uip_chksum_add(0, addrs, ADDRS_LEN));
+  chksum = uip_chksum_update(chksum, get16(PORT_OFFSET), port);
+  memcpy(&packet[ADDRS_OFFSET], addrs, ADDRS_LEN);
+  set16(PORT_OFFSET, port);
+  set16(CHKSUM_OFFSET, chksum);
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(unsigned long n)
+{
+  unsigned long i;
+  uint64_t start;
+  uint32_t total;
+
+  random_data(packet, n);
+  total = 0;
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    total += uip_chksum_add(i, packet, n);
+  }
+  bench_report("chksum", n, "sum", bench_now() - start, ROUNDS);
+  /* Use the sums, so that the loop is not optimized away */
+  bench_check(total != 0, "sum");
+}
+/*---------------------------------------------------------------------------*/
+static void
+run_rewrite(unsigned long n)
+{
+  unsigned long i;
+  uint64_t start;
+
+  random_data(packet, n);
+  random_data(addrs, ADDRS_LEN);
+  set16(CHKSUM_OFFSET, 0);
+  set16(CHKSUM_OFFSET, ~uip_chksum_add(0, packet, n));
+
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    addrs[0] = i;
+    rewrite(i);
+  }
+  bench_report("chksum", n, "update", bench_now() - start, ROUNDS);
+  bench_check(uip_chksum_add(0, packet, n) == 0xffff, "update");
+
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    addrs[0] = i;
+    memcpy(&packet[ADDRS_OFFSET], addrs, ADDRS_LEN);
+    set16(PORT_OFFSET, i);
+    set16(CHKSUM_OFFSET, 0);
+    set16(CHKSUM_OFFSET, ~uip_chksum_add(0, packet, n));
+  }
+  bench_report("chksum", n, "resum", bench_now() - start, ROUNDS);
+  bench_check(uip_chksum_add(0, packet, n) == 0xffff, "resum");
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_sums(void)
+{
+  unsigned long i;
+  uint16_t offset, len, sum;
+  int ok;
+
+  /* Any alignment, length and initial sum */
+  ok = 1;
+  for(i = 0; i < CHECKS; i++) {
+    offset = random_rand() % 8;
+    len = random_rand() % (MAX_SIZE + 1);
+    sum = random_rand();
+    random_data(packet + offset, len);
+    if(uip_chksum_add(sum, packet + offset, len) !=
+       ref_chksum(sum, packet + offset, len)) {
+      ok = 0;
+    }
+  }
+  bench_check(ok, "sums");
+
+  /* The extremes of ones-complement arithmetic */
+  memset(packet, 0, MAX_SIZE);
+  ok = uip_chksum_add(0, packet, MAX_SIZE) == 0 &&
+    uip_chksum_add(0xffff, packet, MAX_SIZE) == 0xffff;
+  memset(packet, 0xff, MAX_SIZE);
+  ok = ok &&
+    uip_chksum_add(0, packet, MAX_SIZE) == ref_chksum(0, packet, MAX_SIZE) &&
+    uip_chksum_add(0xffff, packet, MAX_SIZE - 1) ==
+    ref_chksum(0xffff, packet, MAX_SIZE - 1);
+  bench_check(ok, "extreme sums");
+
+  /* Updated checksums verify */
+  ok = 1;
+  for(i = 0; i < CHECKS; i++) {
+    len = ADDRS_OFFSET + ADDRS_LEN + random_rand() % (MAX_SIZE - ADDRS_LEN);
+    random_data(packet, len);
+    set16(CHKSUM_OFFSET, 0);
+    set16(CHKSUM_OFFSET, ~ref_chksum(0, packet, len));
+    random_data(addrs, ADDRS_LEN);
+    rewrite(random_rand());
+    if(ref_chksum(0, packet, len) != 0xffff) {
+      ok = 0;
+    }
+  }
+  bench_check(ok, "updates");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("chksum benchmark, %s\n", UIP_CHKSUM_WIDE ? "wide" : "16-bit");
+  check_sums();
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+  run_rewrite(1280);
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         CSMA benchmark: the cost of sending frames through CSMA and
+ *         nullrdc to a radio that never fails, either in batches to
+ *         one neighbor or one frame to each of several neighbors.
+ *         Also checks that the frames go out in order and that with
+ *         CSMA_CONF_BURST all but the last of a batch carry the
+ *         frame-pending bit.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "net/mac/csma.h"
+
+#include "bench.h"
+
+#define ROUNDS 20000
+#define PAYLOAD_LEN 64
+/* Frames sent to a neighbor in a batch */
+#define BATCH QUEUEBUF_NUM
+/* Frame control field, first byte: frame pending */
+#define FCF_FRAME_PENDING 0x10
+
+PROCESS(bench_process, "CSMA benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+static unsigned queued, sent_count, in_order, pending_ok;
+static int transmit_ok;
+/*---------------------------------------------------------------------------*/
+static void
+make_addr(linkaddr_t *addr, unsigned i)
+{
+  memset(addr, 0, sizeof(linkaddr_t));
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 2] = i >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sent(void *ptr, int status, int num_tx)
+{
+  unsigned last = (uintptr_t)ptr;
+  const uint8_t *data = packetbuf_dataptr();
+  int pending = (((uint8_t *)packetbuf_hdrptr())[0] & FCF_FRAME_PENDING) != 0;
+
+  transmit_ok &= status == MAC_TX_OK;
+  if(data[0] == sent_count % BATCH) {
+    in_order++;
+  }
+  /* Only the frames with another one behind them in a batch */
+  if(pending == (CSMA_CONF_BURST && !last)) {
+    pending_ok++;
+  }
+  if(++sent_count == queued) {
+    process_poll(&bench_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Queue a frame to a neighbor, the index within its batch as payload */
+static void
+send_frame(unsigned nbr, unsigned index, int last)
+{
+  linkaddr_t addr;
+  uint8_t payload[PAYLOAD_LEN];
+
+  memset(payload, 0, sizeof(payload));
+  payload[0] = index;
+  make_addr(&addr, nbr);
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, sizeof(payload));
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+  queued++;
+  csma_driver.send(sent, (void *)(uintptr_t)last);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  static uint64_t start;
+  static unsigned long round;
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("CSMA benchmark, %s, %s\n",
+         CSMA_CONF_BURST ? "burst" : "no burst",
+         CSMA_CONF_HASH ? "hashed" : "list");
+
+  csma_driver.init();
+  transmit_ok = 1;
+
+  /* Batches of frames to one neighbor */
+  queued = sent_count = in_order = pending_ok = 0;
+  start = bench_now();
+  for(round = 0; round < ROUNDS; round++) {
+    for(i = 0; i < BATCH; i++) {
+      send_frame(1, i, i == BATCH - 1);
+    }
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  }
+  bench_report("csma", BATCH, "batch", bench_now() - start, queued);
+  bench_check(transmit_ok && sent_count == queued && in_order == queued,
+              "batched frames sent in order");
+  bench_check(pending_ok == queued, "frame-pending bit set within batches");
+
+  /* A frame to each of several neighbors */
+  queued = sent_count = 0;
+  start = bench_now();
+  for(round = 0; round < ROUNDS; round++) {
+    for(i = 0; i < CSMA_CONF_MAX_NEIGHBOR_QUEUES; i++) {
+      send_frame(i + 1, 0, 1);
+    }
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  }
+  bench_report("csma", CSMA_CONF_MAX_NEIGHBOR_QUEUES, "neighbors",
+               bench_now() - start, queued);
+  bench_check(transmit_ok && sent_count == queued,
+              "frames to several neighbors sent");
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
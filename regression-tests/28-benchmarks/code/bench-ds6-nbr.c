@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         IPv6 neighbor cache benchmark: the cost of resolving IPv6
+ *         addresses to neighbors as the cache fills up.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "lib/random.h"
+
+#include "bench.h"
+
+#define LOOKUPS 100000
+#define MAX_SIZE 1000
+
+PROCESS(bench_process, "ds6-nbr benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+static uip_ipaddr_t ipaddrs[MAX_SIZE];
+static uip_lladdr_t lladdrs[MAX_SIZE];
+static uip_ipaddr_t misses[MAX_SIZE];
+static const unsigned long sizes[] = { 10, 100, MAX_SIZE };
+static unsigned long added;
+/*---------------------------------------------------------------------------*/
+static void
+random_ipaddr(uip_ipaddr_t *ipaddr)
+{
+  int i;
+
+  uip_ip6addr(ipaddr, 0xfe80, 0, 0, 0, 0, 0, 0, 0);
+  for(i = 8; i < sizeof(uip_ipaddr_t); i++) {
+    ipaddr->u8[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+random_lladdr(uip_lladdr_t *lladdr)
+{
+  int i;
+
+  for(i = 0; i < sizeof(uip_lladdr_t); i++) {
+    lladdr->addr[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_all(unsigned long n)
+{
+  uip_ds6_nbr_t *nbr;
+  unsigned long i;
+
+  for(i = 0; i < n; i++) {
+    nbr = uip_ds6_nbr_lookup(&ipaddrs[i]);
+    if(nbr == NULL || uip_ds6_nbr_ll_lookup(&lladdrs[i]) != nbr) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(unsigned long n)
+{
+  unsigned long i, found;
+  uint64_t start;
+  int ok;
+
+  /* Grow the cache from the size of the previous round */
+  ok = 1;
+  start = bench_now();
+  for(i = added; i < n; i++) {
+    random_ipaddr(&ipaddrs[i]);
+    random_lladdr(&lladdrs[i]);
+    if(uip_ds6_nbr_add(&ipaddrs[i], &lladdrs[i], 0, NBR_REACHABLE,
+                       NBR_TABLE_REASON_UNDEFINED, NULL) == NULL) {
+      ok = 0;
+    }
+  }
+  bench_report("ds6-nbr", n, "add", bench_now() - start, n - added);
+  bench_check(ok, "add");
+  added = n;
+
+  found = 0;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += uip_ds6_nbr_lookup(&ipaddrs[random_rand() % n]) != NULL;
+  }
+  bench_report("ds6-nbr", n, "hit", bench_now() - start, LOOKUPS);
+  bench_check(found == LOOKUPS, "lookup hits");
+
+  for(i = 0; i < n; i++) {
+    random_ipaddr(&misses[i]);
+  }
+  found = 0;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += uip_ds6_nbr_lookup(&misses[random_rand() % n]) != NULL;
+  }
+  bench_report("ds6-nbr", n, "miss", bench_now() - start, LOOKUPS);
+  bench_check(found == 0, "lookup misses");
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_updates(void)
+{
+  uip_ipaddr_t old;
+  unsigned long i;
+  int ok;
+
+  /* Adding a known link-layer address again replaces its IPv6 address */
+  ok = 1;
+  for(i = 0; i < added; i += 4) {
+    uip_ipaddr_copy(&old, &ipaddrs[i]);
+    random_ipaddr(&ipaddrs[i]);
+    if(uip_ds6_nbr_add(&ipaddrs[i], &lladdrs[i], 0, NBR_REACHABLE,
+                       NBR_TABLE_REASON_UNDEFINED, NULL) == NULL ||
+       uip_ds6_nbr_lookup(&old) != NULL) {
+      ok = 0;
+    }
+  }
+  bench_check(ok, "replace");
+  bench_check(check_all(added), "lookup after replace");
+
+  /* Remove every third neighbor, and put the last one in its place */
+  for(i = 0; i < added; i += 3) {
+    if(!uip_ds6_nbr_rm(uip_ds6_nbr_lookup(&ipaddrs[i])) ||
+       uip_ds6_nbr_lookup(&ipaddrs[i]) != NULL) {
+      ok = 0;
+    }
+    added--;
+    uip_ipaddr_copy(&ipaddrs[i], &ipaddrs[added]);
+    memcpy(&lladdrs[i], &lladdrs[added], sizeof(uip_lladdr_t));
+  }
+  bench_check(ok, "remove");
+  bench_check(check_all(added), "lookup after removal");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("ds6-nbr benchmark, %s\n", UIP_DS6_NBR_HASH ? "hash" : "list");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+  check_updates();
+#if UIP_DS6_NBR_HASH
+  printf("ds6-nbr lookups: %lu hits, %lu misses\n",
+         (unsigned long)uip_ds6_nbr_stats.hits,
+         (unsigned long)uip_ds6_nbr_stats.misses);
+#endif /* UIP_DS6_NBR_HASH */
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
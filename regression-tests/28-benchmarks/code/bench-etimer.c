@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Event timer benchmark: the cost of setting, resetting,
+ *         stopping and dispatching etimers, and of dispatching
+ *         ctimers, as the number of pending timers grows. Also
+ *         checks that stopping, adjusting or setting a copy of a
+ *         pending timer, or a timer in uninitialized memory, leaves
+ *         the pending timers alone.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/random.h"
+
+#include "bench.h"
+
+#define MAX_TIMERS 10000
+
+PROCESS(bench_process, "etimer benchmark");
+PROCESS(sink_process, "etimer sink");
+AUTOSTART_PROCESSES(&bench_process);
+
+static struct etimer timers[MAX_TIMERS];
+static struct ctimer ctimers[MAX_TIMERS];
+static const unsigned long sizes[] = { 10, 100, 1000, MAX_TIMERS };
+static unsigned long fired;
+/*---------------------------------------------------------------------------*/
+/* Owns the benchmarked timers, so that their events are not delivered
+   to the benchmark process itself while it drives the scheduler. */
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+    fired++;
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+ctimer_callback(void *ptr)
+{
+  fired++;
+}
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+random_interval(void)
+{
+  /* Far enough into the future not to expire during the benchmark */
+  return 60 * CLOCK_SECOND + random_rand() % (60 * CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(unsigned long n)
+{
+  struct process *current;
+  clock_time_t now, next, first;
+  unsigned long i;
+  uint64_t start;
+
+  PROCESS_CONTEXT_BEGIN(&sink_process);
+
+  start = bench_now();
+  for(i = 0; i < n; i++) {
+    etimer_set(&timers[i], random_interval());
+  }
+  bench_report("etimer", n, "set", bench_now() - start, n);
+
+  now = clock_time();
+  next = etimer_expiration_time(&timers[0]);
+  for(i = 1; i < n; i++) {
+    if(etimer_expiration_time(&timers[i]) - now < next - now) {
+      next = etimer_expiration_time(&timers[i]);
+    }
+  }
+  /* The network stack may have timers of its own pending, which may
+     even have expired while the benchmark timers were set */
+  first = etimer_next_expiration_time();
+  bench_check(first - now <= next - now || now - first < next - now,
+              "next expiration");
+
+  start = bench_now();
+  for(i = 0; i < n; i++) {
+    etimer_next_expiration_time();
+  }
+  bench_report("etimer", n, "next", bench_now() - start, n);
+
+  start = bench_now();
+  for(i = 0; i < n; i++) {
+    etimer_reset_with_new_interval(&timers[random_rand() % n],
+                                   random_interval());
+  }
+  bench_report("etimer", n, "reset", bench_now() - start, n);
+
+  start = bench_now();
+  for(i = 0; i < n; i++) {
+    etimer_stop(&timers[i]);
+  }
+  bench_report("etimer", n, "stop", bench_now() - start, n);
+
+  /* Let all timers expire at once and drive the scheduler until each
+     of them has been dispatched to the sink process. */
+  for(i = 0; i < n; i++) {
+    etimer_set(&timers[i], 0);
+  }
+
+  PROCESS_CONTEXT_END(&sink_process);
+
+  fired = 0;
+  current = PROCESS_CURRENT();
+  start = bench_now();
+  while(fired < n && process_run() > 0);
+  bench_report("etimer", n, "fire", bench_now() - start, n);
+  process_current = current;
+
+  bench_check(fired == n, "all timers fired");
+  for(i = 0; i < n; i++) {
+    if(!etimer_expired(&timers[i])) {
+      bench_check(0, "timer expired");
+      break;
+    }
+  }
+
+  /* Callback timers are run by the etimer process itself */
+  for(i = 0; i < n; i++) {
+    ctimer_set(&ctimers[i], 0, ctimer_callback, NULL);
+  }
+
+  fired = 0;
+  start = bench_now();
+  while(fired < n && process_run() > 0);
+  bench_report("ctimer", n, "fire", bench_now() - start, n);
+  process_current = current;
+
+  bench_check(fired == n, "all ctimers fired");
+}
+/*---------------------------------------------------------------------------*/
+#define STALE_TIMERS 10
+/* A copy of a pending timer carries the position of the original, and
+   a timer in reused memory carries whatever was there before */
+static void
+check_stale(void)
+{
+  static struct etimer stopped, set, garbage;
+  struct process *current;
+  unsigned long i;
+
+  PROCESS_CONTEXT_BEGIN(&sink_process);
+  for(i = 0; i < STALE_TIMERS; i++) {
+    etimer_set(&timers[i], 0);
+  }
+  memcpy(&stopped, &timers[STALE_TIMERS / 2], sizeof(stopped));
+  memcpy(&set, &timers[STALE_TIMERS / 2 + 1], sizeof(set));
+  memset(&garbage, 0xa5, sizeof(garbage));
+  etimer_stop(&stopped);
+  etimer_adjust(&stopped, 1);
+  etimer_set(&set, 0);
+  etimer_set(&garbage, 0);
+  PROCESS_CONTEXT_END(&sink_process);
+
+  fired = 0;
+  current = PROCESS_CURRENT();
+  while(fired < STALE_TIMERS + 2 && process_run() > 0);
+  process_current = current;
+
+  bench_check(fired == STALE_TIMERS + 2 && etimer_expired(&stopped) &&
+              etimer_expired(&garbage), "copies of pending timers");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  process_start(&sink_process, NULL);
+
+  printf("etimer benchmark, %s queue\n", ETIMER_HEAP_SIZE ? "heap" : "list");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+  check_stale();
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
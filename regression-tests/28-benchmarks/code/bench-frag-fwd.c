@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         6LoWPAN fragment forwarding benchmark: the cost per fragment
+ *         of forwarding a fragmented datagram as its fragments arrive,
+ *         and of reassembling one that is for us. Also checks that
+ *         forwarded fragments get a new tag and, for the first one, a
+ *         header compressed for the next hop with the hop limit
+ *         decremented, that the forwarding entry is freed after the
+ *         last fragment, and that datagrams for us, with extension
+ *         headers or without a next hop are reassembled instead.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/ip/tcpip.h"
+#include "net/ip/simple-udp.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/ipv6/sicslowpan.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/rime/rime.h"
+
+#include "bench.h"
+
+#define ROUNDS 10000
+#define PORT 5683
+#define PAYLOAD_LEN 300
+/* Length of the extension headers we add, PadN or routing header */
+#define EXT_LEN 8
+/* Enough for the fragments of a datagram */
+#define MAX_FRAMES 8
+#define HOP_LIMIT 64
+
+#define IP_BUF ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+
+PROCESS(bench_process, "Fragment forwarding benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+struct frame {
+  uint8_t data[PACKETBUF_SIZE];
+  int len;
+  linkaddr_t receiver;
+};
+
+/* The fragments of a datagram, and those we sent */
+static struct frame in[MAX_FRAMES], out[MAX_FRAMES];
+static int in_count, out_count;
+
+/* The datagram we last handed to the IP layer */
+static uint8_t delivered[UIP_BUFSIZE];
+static int delivered_len, delivered_count;
+
+static struct simple_udp_connection conn;
+
+/* The previous hop, and a next hop with and one without a link-layer
+   address */
+static linkaddr_t sender;
+static uip_lladdr_t nexthop_lladdr, incomplete_lladdr;
+static uip_ipaddr_t src_addr, my_addr;
+/* Routed through the next hop, through the incomplete next hop, and
+   without a route */
+static uip_ipaddr_t routed_addr, incomplete_addr, unrouted_addr;
+/*---------------------------------------------------------------------------*/
+static void
+sniff_input(void)
+{
+  delivered_len = uip_len;
+  memcpy(delivered, IP_BUF, uip_len);
+  delivered_count++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sniff_output(int mac_status)
+{
+  if(out_count < MAX_FRAMES) {
+    out[out_count].len = packetbuf_datalen();
+    memcpy(out[out_count].data, packetbuf_dataptr(), out[out_count].len);
+    linkaddr_copy(&out[out_count].receiver,
+                  packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+  }
+  out_count++;
+}
+/*---------------------------------------------------------------------------*/
+RIME_SNIFFER(sniffer, sniff_input, sniff_output);
+/*---------------------------------------------------------------------------*/
+static void
+receiver(struct simple_udp_connection *c,
+         const uip_ipaddr_t *sender_addr,
+         uint16_t sender_port,
+         const uip_ipaddr_t *receiver_addr,
+         uint16_t receiver_port,
+         const uint8_t *data,
+         uint16_t datalen)
+{
+}
+/*---------------------------------------------------------------------------*/
+/* Put a UDP datagram in uip_buf, behind an extension header if proto
+   is not UDP */
+static void
+make_datagram(const uip_ipaddr_t *dest, uint8_t proto, uint8_t hop_limit)
+{
+  uint8_t *ext = &uip_buf[UIP_LLIPH_LEN];
+  int ext_len = proto == UIP_PROTO_UDP ? 0 : EXT_LEN;
+  struct uip_udp_hdr *udp = (struct uip_udp_hdr *)&ext[ext_len];
+  uint8_t *payload = (uint8_t *)(udp + 1);
+  int len = ext_len + UIP_UDPH_LEN + PAYLOAD_LEN;
+  int i;
+
+  uip_clear_buf();
+  memset(uip_buf, 0, UIP_LLIPH_LEN + len);
+  IP_BUF->vtc = 0x60;
+  IP_BUF->len[0] = len >> 8;
+  IP_BUF->len[1] = len & 0xff;
+  IP_BUF->proto = proto;
+  IP_BUF->ttl = hop_limit;
+  uip_ipaddr_copy(&IP_BUF->srcipaddr, &src_addr);
+  uip_ipaddr_copy(&IP_BUF->destipaddr, dest);
+  if(proto == UIP_PROTO_HBHO) {
+    /* A PadN option filling the header */
+    ext[0] = UIP_PROTO_UDP;
+    ext[2] = UIP_EXT_HDR_OPT_PADN;
+    ext[3] = EXT_LEN - 4;
+  } else if(proto == UIP_PROTO_ROUTING) {
+    /* A source routing header with no segment left */
+    ext[0] = UIP_PROTO_UDP;
+    ext[2] = 3;
+  }
+  udp->srcport = UIP_HTONS(PORT);
+  udp->destport = UIP_HTONS(PORT);
+  udp->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    payload[i] = i;
+  }
+  uip_len = UIP_IPH_LEN + len;
+  if(proto == UIP_PROTO_UDP) {
+    udp->udpchksum = ~uip_udpchksum();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Fragment the datagram in uip_buf towards a link-layer address, into
+   frames */
+static int
+fragment(const uip_lladdr_t *dest, struct frame *frames)
+{
+  out_count = 0;
+  tcpip_output(dest);
+  memcpy(frames, out, sizeof(out));
+  return out_count;
+}
+/*---------------------------------------------------------------------------*/
+/* Receive the fragments of a datagram from the previous hop */
+static void
+receive(void)
+{
+  int i;
+
+  for(i = 0; i < in_count; i++) {
+    packetbuf_copyfrom(in[i].data, in[i].len);
+    packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+    packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, (linkaddr_t *)&uip_lladdr);
+    NETSTACK_NETWORK.input();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+frag_tag(const struct frame *f)
+{
+  return (f->data[2] << 8) | f->data[3];
+}
+/*---------------------------------------------------------------------------*/
+/* Compare two fragments, all but their tags */
+static int
+same_but_tag(const struct frame *a, const struct frame *b)
+{
+  return a->len == b->len && memcmp(a->data, b->data, 2) == 0 &&
+    memcmp(&a->data[4], &b->data[4], a->len - 4) == 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Get the hop limit from the IPHC header of a first fragment, for the
+   datagrams of make_datagram(): traffic class and flow label elided
+   and UDP header compressed */
+static int
+hop_limit(const struct frame *f)
+{
+  const uint8_t *iphc = &f->data[SICSLOWPAN_FRAG1_HDR_LEN];
+
+  switch(iphc[0] & 0x03) {
+  case SICSLOWPAN_IPHC_TTL_1:
+    return 1;
+  case SICSLOWPAN_IPHC_TTL_64:
+    return 64;
+  case SICSLOWPAN_IPHC_TTL_255:
+    return 255;
+  }
+  return iphc[(iphc[1] & SICSLOWPAN_IPHC_CID) ? 3 : 2];
+}
+/*---------------------------------------------------------------------------*/
+/* Check that a datagram is forwarded fragment by fragment */
+static void
+check_forward(void)
+{
+  struct frame expected[MAX_FRAMES];
+  struct sicslowpan_frag_stats before = sicslowpan_frag_stats;
+  int i, ok;
+
+  /* What we would send the next hop for the same datagram */
+  make_datagram(&routed_addr, UIP_PROTO_UDP, HOP_LIMIT - 1);
+  fragment(&nexthop_lladdr, expected);
+  make_datagram(&routed_addr, UIP_PROTO_UDP, HOP_LIMIT);
+  in_count = fragment(&uip_lladdr, in);
+  bench_check(in_count >= 3 && in_count <= MAX_FRAMES,
+              "datagram in several fragments");
+
+  out_count = delivered_count = 0;
+  receive();
+  ok = out_count == in_count && delivered_count == 0;
+  for(i = 0; ok && i < in_count; i++) {
+    ok = linkaddr_cmp(&out[i].receiver, (linkaddr_t *)&nexthop_lladdr);
+  }
+  bench_check(ok, "every fragment forwarded to the next hop");
+  bench_check(sicslowpan_frag_stats.forwarded - before.forwarded == in_count &&
+              sicslowpan_frag_stats.reassembled == before.reassembled &&
+              sicslowpan_frag_stats.dropped == before.dropped,
+              "forwarded fragments counted");
+  if(!ok) {
+    return;
+  }
+
+  ok = frag_tag(&out[0]) != frag_tag(&in[0]);
+  for(i = 1; i < in_count; i++) {
+    ok = ok && frag_tag(&out[i]) == frag_tag(&out[0]);
+  }
+  bench_check(ok, "tag rewritten");
+  bench_check(same_but_tag(&out[0], &expected[0]),
+              "first fragment compressed for the next hop");
+  bench_check(hop_limit(&in[0]) == HOP_LIMIT &&
+              hop_limit(&out[0]) == HOP_LIMIT - 1,
+              "hop limit decremented");
+  ok = 1;
+  for(i = 1; i < in_count; i++) {
+    ok = ok && same_but_tag(&out[i], &in[i]);
+  }
+  bench_check(ok, "subsequent fragments unchanged but for the tag");
+
+  /* The entry is gone: a stray last fragment has nowhere to go */
+  before = sicslowpan_frag_stats;
+  out_count = 0;
+  packetbuf_copyfrom(in[in_count - 1].data, in[in_count - 1].len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, (linkaddr_t *)&uip_lladdr);
+  NETSTACK_NETWORK.input();
+  bench_check(out_count == 0 &&
+              sicslowpan_frag_stats.forwarded == before.forwarded &&
+              sicslowpan_frag_stats.dropped - before.dropped == 1,
+              "forwarding entry freed after the last fragment");
+}
+/*---------------------------------------------------------------------------*/
+/* Check that a datagram is reassembled and handed to the IP layer
+   rather than forwarded */
+static void
+check_reassembly(const uip_ipaddr_t *dest, uint8_t proto, const char *what)
+{
+  uint8_t datagram[UIP_BUFSIZE];
+  int len;
+  struct sicslowpan_frag_stats before = sicslowpan_frag_stats;
+  static char msg[80];
+
+  make_datagram(dest, proto, HOP_LIMIT);
+  len = uip_len;
+  memcpy(datagram, IP_BUF, len);
+  in_count = fragment(&uip_lladdr, in);
+
+  delivered_count = 0;
+  receive();
+  snprintf(msg, sizeof(msg), "%s reassembled", what);
+  bench_check(delivered_count == 1 && delivered_len == len &&
+              memcmp(delivered, datagram, len) == 0 &&
+              sicslowpan_frag_stats.forwarded == before.forwarded &&
+              sicslowpan_frag_stats.reassembled - before.reassembled == in_count &&
+              sicslowpan_frag_stats.dropped == before.dropped, msg);
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_addresses(void)
+{
+  uip_ipaddr_t nexthop_addr, incomplete_nexthop_addr;
+  int i;
+
+  for(i = 0; i < sizeof(uip_lladdr_t); i++) {
+    sender.u8[i] = 0x10 + i;
+    nexthop_lladdr.addr[i] = 0x20 + i;
+    incomplete_lladdr.addr[i] = 0x30 + i;
+  }
+  uip_ip6addr(&src_addr, 0x2001, 0xdb8, 1, 0, 0, 0, 0, 1);
+  uip_ip6addr(&my_addr, 0x2001, 0xdb8, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&my_addr, &uip_lladdr);
+  uip_ds6_addr_add(&my_addr, 0, ADDR_MANUAL);
+  uip_ip6addr(&routed_addr, 0x2001, 0xdb8, 2, 0, 0, 0, 0, 1);
+  uip_ip6addr(&incomplete_addr, 0x2001, 0xdb8, 2, 0, 0, 0, 0, 2);
+  uip_ip6addr(&unrouted_addr, 0x2001, 0xdb8, 3, 0, 0, 0, 0, 1);
+
+  uip_ip6addr(&nexthop_addr, 0xfe80, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&nexthop_addr, &nexthop_lladdr);
+  uip_ds6_nbr_add(&nexthop_addr, &nexthop_lladdr, 1, NBR_REACHABLE,
+                  NBR_TABLE_REASON_UNDEFINED, NULL);
+  uip_ds6_route_add(&routed_addr, 128, &nexthop_addr);
+
+  uip_ip6addr(&incomplete_nexthop_addr, 0xfe80, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&incomplete_nexthop_addr, &incomplete_lladdr);
+  uip_ds6_nbr_add(&incomplete_nexthop_addr, &incomplete_lladdr, 1,
+                  NBR_INCOMPLETE, NBR_TABLE_REASON_UNDEFINED, NULL);
+  uip_ds6_route_add(&incomplete_addr, 128, &incomplete_nexthop_addr);
+}
+/*---------------------------------------------------------------------------*/
+/* Time the handling of the fragments in in[] */
+static void
+run(const char *op)
+{
+  unsigned long i;
+  uint64_t start;
+
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    receive();
+  }
+  bench_report("frag-fwd", in_count, op, bench_now() - start,
+               ROUNDS * in_count);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  struct sicslowpan_frag_stats before;
+
+  PROCESS_BEGIN();
+
+  printf("Fragment forwarding benchmark, %d datagrams at a time\n",
+         SICSLOWPAN_FRAG_FORWARD);
+
+  make_addresses();
+  simple_udp_register(&conn, PORT, NULL, PORT, receiver);
+  rime_sniffer_add(&sniffer);
+
+  check_forward();
+  check_reassembly(&my_addr, UIP_PROTO_UDP, "datagram for us");
+  check_reassembly(&routed_addr, UIP_PROTO_HBHO, "datagram with hop-by-hop options");
+  check_reassembly(&routed_addr, UIP_PROTO_ROUTING, "datagram with a routing header");
+  check_reassembly(&incomplete_addr, UIP_PROTO_UDP, "datagram to an unresolved next hop");
+  check_reassembly(&unrouted_addr, UIP_PROTO_UDP, "datagram without a route");
+
+  /* Every datagram gets through, so the forwarding entries are reused */
+  make_datagram(&routed_addr, UIP_PROTO_UDP, HOP_LIMIT);
+  in_count = fragment(&uip_lladdr, in);
+  before = sicslowpan_frag_stats;
+  run("forward");
+  bench_check(sicslowpan_frag_stats.forwarded - before.forwarded ==
+              ROUNDS * in_count, "all fragments forwarded");
+
+  make_datagram(&my_addr, UIP_PROTO_UDP, HOP_LIMIT);
+  in_count = fragment(&uip_lladdr, in);
+  delivered_count = 0;
+  run("reassemble");
+  bench_check(delivered_count == ROUNDS, "all datagrams reassembled");
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
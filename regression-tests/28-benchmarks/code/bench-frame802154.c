@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         IEEE 802.15.4 framer benchmark: the cost of creating the
+ *         header of a data frame to one of a few destinations, with
+ *         FRAMER_802154_CONF_HDR_CACHE templates, and of parsing it,
+ *         with FRAME802154_CONF_PARSE_FAST. Also checks that frames
+ *         from a template match the first one built for a destination
+ *         and that parsed fields match the ones the frame was made of.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/mac/frame802154.h"
+#include "net/mac/framer-802154.h"
+
+#include "bench.h"
+
+#define ROUNDS 200000
+#define PAYLOAD_LEN 64
+
+PROCESS(bench_process, "IEEE 802.15.4 framer benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+static const unsigned sizes[] = { 1, 4, 16 };
+static uint8_t first_hdr[16][32];
+static int first_len[16];
+/*---------------------------------------------------------------------------*/
+static void
+make_addr(linkaddr_t *addr, unsigned i)
+{
+  memset(addr, 0, sizeof(linkaddr_t));
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 2] = i >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = i;
+}
+/*---------------------------------------------------------------------------*/
+/* Create an acked data frame to a destination in the packetbuf */
+static int
+create(unsigned dest)
+{
+  static uint8_t payload[PAYLOAD_LEN];
+  linkaddr_t addr;
+
+  make_addr(&addr, dest);
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, sizeof(payload));
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, 1);
+  return framer_802154.create();
+}
+/*---------------------------------------------------------------------------*/
+/* Check the frame in the packetbuf against the first one created for its
+   destination, except for the sequence number, and parse it back */
+static int
+check_frame(unsigned dest, int len)
+{
+  frame802154_t frame;
+  linkaddr_t addr;
+  uint8_t *hdr = packetbuf_hdrptr();
+  int ok = 1;
+
+  if(first_len[dest] == 0) {
+    first_len[dest] = len;
+    memcpy(first_hdr[dest], hdr, len);
+  }
+  ok &= len == first_len[dest];
+  ok &= memcmp(hdr, first_hdr[dest], 2) == 0;
+  ok &= memcmp(hdr + 3, first_hdr[dest] + 3, len - 3) == 0;
+  ok &= hdr[2] == (uint8_t)packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO);
+
+  make_addr(&addr, dest);
+  ok &= frame802154_parse(hdr, packetbuf_totlen(), &frame) == len;
+  ok &= frame.fcf.frame_type == FRAME802154_DATAFRAME;
+  ok &= frame.fcf.ack_required == 1;
+  ok &= frame.seq == hdr[2];
+  ok &= frame.dest_pid == frame802154_get_pan_id();
+  ok &= frame.src_pid == frame802154_get_pan_id();
+  ok &= linkaddr_cmp((linkaddr_t *)frame.dest_addr, &addr);
+  ok &= linkaddr_cmp((linkaddr_t *)frame.src_addr, &linkaddr_node_addr);
+  ok &= frame.payload_len == PAYLOAD_LEN;
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+/* Parse frames with short addresses, and with other shapes, the same way
+   as they were made */
+static int
+check_parse(void)
+{
+  static const uint8_t addr_modes[] = {
+    FRAME802154_SHORTADDRMODE, FRAME802154_LONGADDRMODE
+  };
+  frame802154_t p, frame;
+  uint8_t buf[64];
+  int i, j, len;
+  int ok = 1;
+
+  for(i = 0; i < 2; i++) {
+    for(j = 0; j < 4; j++) {
+      memset(&p, 0, sizeof(p));
+      p.fcf.frame_type = FRAME802154_DATAFRAME;
+      p.fcf.frame_version = FRAME802154_IEEE802154_2006;
+      p.fcf.dest_addr_mode = addr_modes[i];
+      /* Same or other address mode, same or other PAN ID */
+      p.fcf.src_addr_mode = addr_modes[i ^ (j & 1)];
+      p.fcf.frame_pending = 1;
+      p.seq = 42 + j;
+      p.dest_pid = 0xabcd;
+      p.src_pid = j & 2 ? 0x1234 : 0xabcd;
+      memcpy(p.dest_addr, "\x01\x02\x03\x04\x05\x06\x07\x08", 8);
+      memcpy(p.src_addr, "\x11\x12\x13\x14\x15\x16\x17\x18", 8);
+      len = frame802154_create(&p, buf);
+
+      ok &= frame802154_parse(buf, len + 10, &frame) == len;
+      ok &= frame.fcf.frame_pending == 1;
+      ok &= frame.fcf.src_addr_mode == p.fcf.src_addr_mode;
+      ok &= frame.seq == p.seq;
+      ok &= frame.dest_pid == p.dest_pid && frame.src_pid == p.src_pid;
+      ok &= memcmp(frame.dest_addr, p.dest_addr,
+                   addr_modes[i] == FRAME802154_SHORTADDRMODE ? 2 : 8) == 0;
+      ok &= memcmp(frame.src_addr, p.src_addr,
+                   p.fcf.src_addr_mode == FRAME802154_SHORTADDRMODE ? 2 : 8) == 0;
+      ok &= frame.payload == buf + len && frame.payload_len == 10;
+    }
+  }
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  frame802154_t frame;
+  uint64_t start;
+  unsigned long i;
+  int s, len, ok;
+
+  PROCESS_BEGIN();
+
+  printf("IEEE 802.15.4 framer benchmark, %d cached headers, %s parse\n",
+         FRAMER_802154_HDR_CACHE, FRAME802154_PARSE_FAST ? "fast" : "full");
+
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    start = bench_now();
+    for(i = 0; i < ROUNDS; i++) {
+      create(i % sizes[s]);
+    }
+    bench_report("frame802154", sizes[s], "create", bench_now() - start,
+                 ROUNDS);
+
+    ok = 1;
+    for(i = 0; i < 2 * sizes[s]; i++) {
+      len = create(i % sizes[s]);
+      ok &= len > 0 && check_frame(i % sizes[s], len);
+    }
+    bench_check(ok, "frames match the first one to their destination");
+  }
+
+  len = create(0);
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    frame802154_parse(packetbuf_hdrptr(), packetbuf_totlen(), &frame);
+  }
+  bench_report("frame802154", 1, "parse", bench_now() - start, ROUNDS);
+  bench_check(check_parse(), "frames parsed as created");
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
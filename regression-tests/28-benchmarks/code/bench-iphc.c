@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         6LoWPAN IPHC benchmark: the cost of sending a UDP datagram
+ *         through 6LoWPAN, for packets of a single flow and for a new
+ *         flow every packet, and of receiving it. Also checks that
+ *         cached headers are the ones IPHC computes, that they carry
+ *         the checksum of each packet, and that the header comes out
+ *         of decompression unchanged.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/ip/tcpip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/sicslowpan.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/rime/rime.h"
+
+#include "bench.h"
+
+#define ROUNDS 200000
+#define PAYLOAD_LEN 32
+#define HDR_LEN (UIP_IPH_LEN + UIP_UDPH_LEN)
+#define CONTEXTS SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS
+
+#define IP_BUF ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UDP_BUF ((struct uip_udp_hdr *)&uip_buf[UIP_LLIPH_LEN])
+
+PROCESS(bench_process, "IPHC benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+/* The datagram, and the next hop it is sent to */
+static uint8_t packet[HDR_LEN + PAYLOAD_LEN];
+static uip_lladdr_t nexthop;
+
+/* The last frame sent and the last header received */
+static uint8_t frame[PACKETBUF_SIZE];
+static int frame_len;
+static uint8_t received[HDR_LEN];
+static int capture;
+/*---------------------------------------------------------------------------*/
+static void
+sniff_input(void)
+{
+  if(capture) {
+    memcpy(received, IP_BUF, HDR_LEN);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+sniff_output(int mac_status)
+{
+  if(capture) {
+    frame_len = packetbuf_datalen();
+    memcpy(frame, packetbuf_dataptr(), frame_len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+RIME_SNIFFER(sniffer, sniff_input, sniff_output);
+/*---------------------------------------------------------------------------*/
+/* A CoAP datagram from our own address to a node under the prefix of
+   the last context */
+static void
+make_packet(void)
+{
+  struct uip_ip_hdr *ip = (struct uip_ip_hdr *)packet;
+  struct uip_udp_hdr *udp = (struct uip_udp_hdr *)&packet[UIP_IPH_LEN];
+  int i;
+
+  memset(packet, 0, sizeof(packet));
+  ip->vtc = 0x60;
+  ip->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+  ip->proto = UIP_PROTO_UDP;
+  ip->ttl = 64;
+  uip_ip6addr(&ip->srcipaddr, UIP_DS6_DEFAULT_PREFIX, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&ip->srcipaddr, &uip_lladdr);
+  uip_ip6addr(&ip->destipaddr, 0x2001, 0xdb8, CONTEXTS - 1, 0, 0, 0, 0, 0);
+  for(i = 0; i < sizeof(nexthop.addr); i++) {
+    nexthop.addr[i] = i + 1;
+  }
+  uip_ds6_set_addr_iid(&ip->destipaddr, &nexthop);
+  udp->srcport = UIP_HTONS(5683);
+  udp->destport = UIP_HTONS(5683);
+  udp->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  udp->udpchksum = UIP_HTONS(0x1234);
+  for(i = HDR_LEN; i < sizeof(packet); i++) {
+    packet[i] = i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+send(void)
+{
+  memcpy(IP_BUF, packet, sizeof(packet));
+  uip_len = sizeof(packet);
+  tcpip_output(&nexthop);
+}
+/*---------------------------------------------------------------------------*/
+static void
+receive(void)
+{
+  packetbuf_copyfrom(frame, frame_len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, (linkaddr_t *)&uip_lladdr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, (linkaddr_t *)&nexthop);
+  NETSTACK_NETWORK.input();
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(void)
+{
+  uint8_t first[PACKETBUF_SIZE];
+  int first_len;
+  int chksum_offset;
+
+  capture = 1;
+
+  send();
+  memcpy(first, frame, frame_len);
+  first_len = frame_len;
+  /* IPHC with context identifiers, both addresses elided, then the
+     LOWPAN_UDP byte, ports and checksum */
+  bench_check(first_len == 3 + 5 + 2 + PAYLOAD_LEN &&
+              (first[2] & 0x0f) == CONTEXTS - 1,
+              "destination compressed with the last context");
+
+  send();
+  bench_check(frame_len == first_len && memcmp(frame, first, first_len) == 0,
+              "same header for the next packet of the flow");
+
+  /* The checksum ends the header, just before the payload */
+  chksum_offset = first_len - PAYLOAD_LEN - 2;
+  ((struct uip_udp_hdr *)&packet[UIP_IPH_LEN])->udpchksum = UIP_HTONS(0xabcd);
+  send();
+  bench_check(frame_len == first_len &&
+              memcmp(frame, first, chksum_offset) == 0 &&
+              frame[chksum_offset] == 0xab && frame[chksum_offset + 1] == 0xcd &&
+              memcmp(&frame[chksum_offset + 2], &first[chksum_offset + 2],
+                     PAYLOAD_LEN) == 0,
+              "checksum of each packet in the header");
+
+  receive();
+  bench_check(memcmp(received, packet, HDR_LEN) == 0,
+              "header unchanged through decompression");
+
+  capture = 0;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  static uint8_t prefix[8] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0 };
+  unsigned long i;
+  uint64_t start;
+  int c;
+
+  PROCESS_BEGIN();
+
+  printf("IPHC benchmark, %d contexts\n", CONTEXTS);
+
+  /* Context 0 is the default prefix, the others 2001:db8:c::/64 */
+  for(c = 1; c < CONTEXTS; c++) {
+    prefix[5] = c;
+    sicslowpan_set_addr_context(c, prefix);
+  }
+  rime_sniffer_add(&sniffer);
+  make_packet();
+
+  check();
+
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    send();
+  }
+  bench_report("iphc", CONTEXTS, "send flow", bench_now() - start, ROUNDS);
+
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    packet[UIP_IPH_LEN - 1] = i;
+    send();
+  }
+  bench_report("iphc", CONTEXTS, "send new flow", bench_now() - start, ROUNDS);
+
+  capture = 1;
+  send();
+  capture = 0;
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    receive();
+  }
+  bench_report("iphc", CONTEXTS, "receive", bench_now() - start, ROUNDS);
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
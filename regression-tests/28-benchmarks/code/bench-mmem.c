@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Managed memory benchmark: the cost of freeing and
+ *         reallocating blocks as the number of live blocks grows.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/mmem.h"
+#include "lib/random.h"
+
+#include "bench.h"
+
+#define MAX_BLOCKS 1000
+#define ROUNDS     10000
+
+PROCESS(bench_process, "mmem benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+static struct mmem blocks[MAX_BLOCKS];
+static const unsigned long sizes[] = { 10, 100, MAX_BLOCKS };
+/*---------------------------------------------------------------------------*/
+static unsigned int
+random_size(void)
+{
+  return 8 + random_rand() % 32;
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_block(struct mmem *m, unsigned long i)
+{
+  unsigned char *p = (unsigned char *)MMEM_PTR(m);
+  unsigned int j;
+
+  for(j = 0; j < m->size; j++) {
+    if(p[j] != (unsigned char)i) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(unsigned long n)
+{
+  struct mmem_stats stats;
+  unsigned long i, r;
+  unsigned int size;
+  uint64_t start;
+  int ok;
+
+  ok = 1;
+  start = bench_now();
+  for(i = 0; i < n; i++) {
+    ok &= mmem_alloc(&blocks[i], random_size());
+  }
+  bench_report("mmem", n, "alloc", bench_now() - start, n);
+  bench_check(ok, "initial allocation");
+
+  for(i = 0; i < n; i++) {
+    memset(MMEM_PTR(&blocks[i]), i, blocks[i].size);
+  }
+
+  /* Replace random blocks, keeping the number of live blocks at n */
+  start = bench_now();
+  for(r = 0; r < ROUNDS; r++) {
+    i = random_rand() % n;
+    size = blocks[i].size;
+    mmem_free(&blocks[i]);
+    ok &= mmem_alloc(&blocks[i], size);
+  }
+  bench_report("mmem", n, "free+alloc", bench_now() - start, ROUNDS);
+  bench_check(ok, "reallocation");
+
+  for(i = 0; i < n; i++) {
+    memset(MMEM_PTR(&blocks[i]), i, blocks[i].size);
+  }
+  for(i = 0; i < n; i++) {
+    ok &= check_block(&blocks[i], i);
+  }
+  bench_check(ok, "block contents");
+
+  mmem_stats(&stats);
+  printf("mmem size %6lu used %u bytes in %u blocks, free %u bytes in %u blocks, largest %u\n",
+         n, stats.used_bytes, stats.used_blocks,
+         stats.free_bytes, stats.free_blocks, stats.largest_free);
+
+  /* Free in scattered order; 7919 is prime, so this visits every block */
+  start = bench_now();
+  for(i = 0; i < n; i++) {
+    mmem_free(&blocks[(i * 7919) % n]);
+  }
+  bench_report("mmem", n, "free", bench_now() - start, n);
+
+  mmem_stats(&stats);
+  bench_check(stats.used_blocks == 0, "all blocks freed");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  mmem_init();
+
+  printf("mmem benchmark, %s\n",
+         MMEM_SIZE_CLASSES ? "size classes" : "compaction");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Neighbor table benchmark: the cost of looking neighbors up
+ *         by link-layer address as the table fills up.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "lib/random.h"
+
+#include "bench.h"
+
+#define LOOKUPS 100000
+#define MAX_SIZE 1000
+
+PROCESS(bench_process, "nbr-table benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+struct bench_nbr {
+  unsigned long id;
+};
+
+NBR_TABLE(struct bench_nbr, bench_nbrs);
+
+static linkaddr_t addrs[MAX_SIZE];
+static linkaddr_t misses[MAX_SIZE];
+/* The network stack keeps a few neighbors of its own */
+static const unsigned long sizes[] = { 10, 100, MAX_SIZE };
+static unsigned long added;
+/*---------------------------------------------------------------------------*/
+static void
+random_addr(linkaddr_t *addr)
+{
+  int i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    addr->u8[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_all(unsigned long n)
+{
+  struct bench_nbr *nbr;
+  unsigned long i;
+
+  for(i = 0; i < n; i++) {
+    nbr = nbr_table_get_from_lladdr(bench_nbrs, &addrs[i]);
+    if(nbr == NULL || !linkaddr_cmp(nbr_table_get_lladdr(bench_nbrs, nbr),
+                                    &addrs[i])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(unsigned long n)
+{
+  struct bench_nbr *nbr;
+  unsigned long i, found;
+  uint64_t start;
+  int ok;
+
+  /* Grow the table from the size of the previous round. The table
+     cannot be emptied, since RPL's neighbor policy does not let
+     neighbors be evicted for this benchmark. */
+  ok = 1;
+  start = bench_now();
+  for(i = added; i < n; i++) {
+    random_addr(&addrs[i]);
+    nbr = nbr_table_add_lladdr(bench_nbrs, &addrs[i],
+                               NBR_TABLE_REASON_UNDEFINED, NULL);
+    if(nbr == NULL) {
+      ok = 0;
+    } else {
+      nbr->id = i;
+    }
+  }
+  bench_report("nbr-table", n, "add", bench_now() - start, n - added);
+  bench_check(ok, "add");
+  added = n;
+
+  found = 0;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += nbr_table_get_from_lladdr(bench_nbrs,
+                                       &addrs[random_rand() % n]) != NULL;
+  }
+  bench_report("nbr-table", n, "hit", bench_now() - start, LOOKUPS);
+  bench_check(found == LOOKUPS, "lookup hits");
+
+  for(i = 0; i < n; i++) {
+    random_addr(&misses[i]);
+  }
+  found = 0;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += nbr_table_get_from_lladdr(bench_nbrs,
+                                       &misses[random_rand() % n]) != NULL;
+  }
+  bench_report("nbr-table", n, "miss", bench_now() - start, LOOKUPS);
+  bench_check(found == 0, "lookup misses");
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_updates(void)
+{
+  linkaddr_t addr;
+  unsigned long i;
+  int ok;
+
+  /* Give a quarter of the neighbors new addresses */
+  ok = 1;
+  for(i = 0; i < added; i += 4) {
+    random_addr(&addr);
+    if(nbr_table_update_lladdr(&addrs[i], &addr, 0)) {
+      linkaddr_copy(&addrs[i], &addr);
+    } else {
+      ok = 0;
+    }
+  }
+  bench_check(ok, "update");
+  bench_check(check_all(added), "lookup after update");
+
+  /* Moving a neighbor onto the address of another one removes it */
+  for(i = 1; i < added; i += 8) {
+    nbr_table_update_lladdr(&addrs[i], &addrs[i + 1], 1);
+  }
+  for(i = 1; i < added; i += 8) {
+    if(nbr_table_get_from_lladdr(bench_nbrs, &addrs[i]) != NULL) {
+      ok = 0;
+    }
+    linkaddr_copy(&addrs[i], &addrs[i + 1]);
+  }
+  bench_check(ok, "remove duplicates");
+  bench_check(check_all(added), "lookup after removal");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  nbr_table_register(bench_nbrs, NULL);
+
+  printf("nbr-table benchmark, %s\n", NBR_TABLE_HASH ? "hash" : "list");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+  check_updates();
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
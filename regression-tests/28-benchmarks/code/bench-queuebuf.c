@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Queuebuf benchmark: the cost of queueing the packetbuf and
+ *         getting it back, as a MAC layer does for every frame it
+ *         sends, and checks that queued packets are not affected by
+ *         later use of the packetbuf.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "lib/random.h"
+
+#include "bench.h"
+
+#define ROUNDS 1000000
+#define FRAME_LEN (PACKETBUF_SIZE - 2 * HDR_LEN)
+#define HDR_LEN 10
+
+PROCESS(bench_process, "queuebuf benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+static uint8_t frames[QUEUEBUF_NUM + 1][PACKETBUF_SIZE];
+/*---------------------------------------------------------------------------*/
+static void
+make_frame(int i)
+{
+  int j;
+
+  for(j = 0; j < PACKETBUF_SIZE; j++) {
+    frames[i][j] = random_rand();
+  }
+  packetbuf_copyfrom(frames[i], FRAME_LEN);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, i);
+}
+/*---------------------------------------------------------------------------*/
+static int
+queued_ok(struct queuebuf *q, int i)
+{
+  return q != NULL && queuebuf_datalen(q) == FRAME_LEN &&
+    memcmp(queuebuf_dataptr(q), frames[i], FRAME_LEN) == 0 &&
+    queuebuf_attr(q, PACKETBUF_ATTR_MAC_SEQNO) == i;
+}
+/*---------------------------------------------------------------------------*/
+static int
+packetbuf_ok(int i)
+{
+  return packetbuf_datalen() == FRAME_LEN &&
+    memcmp(packetbuf_const_dataptr(), frames[i], FRAME_LEN) == 0 &&
+    packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) == i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(void)
+{
+  struct queuebuf *q;
+  unsigned long i;
+  uint64_t start;
+  int ok;
+
+  make_frame(0);
+  ok = 1;
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    q = queuebuf_new_from_packetbuf();
+    queuebuf_to_packetbuf(q);
+    queuebuf_free(q);
+  }
+  bench_report("queuebuf", FRAME_LEN, "queue", bench_now() - start, ROUNDS);
+  bench_check(packetbuf_ok(0), "queue");
+
+  /* Receive a frame, queue it and add a header when sending it */
+  start = bench_now();
+  for(i = 0; i < ROUNDS; i++) {
+    packetbuf_copyfrom(frames[0], FRAME_LEN);
+    q = queuebuf_new_from_packetbuf();
+    queuebuf_to_packetbuf(q);
+    if(!packetbuf_hdralloc(HDR_LEN)) {
+      ok = 0;
+    }
+    queuebuf_free(q);
+  }
+  bench_report("queuebuf", FRAME_LEN, "forward", bench_now() - start, ROUNDS);
+  bench_check(ok, "forward");
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_queued(void)
+{
+  struct queuebuf *queued[QUEUEBUF_NUM];
+  int i, ok;
+
+  /* Fill the queue, writing to the packetbuf after each packet */
+  ok = 1;
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    make_frame(i);
+    queued[i] = queuebuf_new_from_packetbuf();
+    memset(packetbuf_dataptr(), 0, FRAME_LEN);
+    packetbuf_hdralloc(HDR_LEN);
+    packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 0xffff);
+  }
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    ok = ok && queued_ok(queued[i], i);
+  }
+  bench_check(ok, "queued packets");
+  make_frame(QUEUEBUF_NUM);
+  bench_check(queuebuf_new_from_packetbuf() == NULL, "full queue");
+  bench_check(packetbuf_ok(QUEUEBUF_NUM), "packetbuf with full queue");
+
+  /* Get the packets back, and modify them in the packetbuf */
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    queuebuf_to_packetbuf(queued[i]);
+    ok = ok && packetbuf_ok(i);
+#if PACKETBUF_POOL_SIZE
+    /* Reading the packet does not copy it */
+    ok = ok && packetbuf_const_hdrptr() == queuebuf_dataptr(queued[i]);
+#endif /* PACKETBUF_POOL_SIZE */
+    ((uint8_t *)packetbuf_dataptr())[0]++;
+    ok = ok && queued_ok(queued[i], i);
+  }
+  bench_check(ok, "restored packets");
+
+  /* Update a queued packet from the packetbuf */
+  make_frame(QUEUEBUF_NUM);
+  queuebuf_update_from_packetbuf(queued[0]);
+  ok = queued_ok(queued[0], QUEUEBUF_NUM);
+  packetbuf_clear();
+  ok = ok && queued_ok(queued[0], QUEUEBUF_NUM);
+  bench_check(ok, "updated packet");
+
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    queuebuf_free(queued[i]);
+  }
+
+  /* A packet with a reduced header is queued without the header */
+  make_frame(0);
+  packetbuf_copyfrom(frames[0], FRAME_LEN + HDR_LEN);
+  packetbuf_hdrreduce(HDR_LEN);
+  queued[0] = queuebuf_new_from_packetbuf();
+  ok = queued[0] != NULL && queuebuf_datalen(queued[0]) == FRAME_LEN &&
+    memcmp(queuebuf_dataptr(queued[0]), frames[0] + HDR_LEN, FRAME_LEN) == 0;
+  queuebuf_free(queued[0]);
+  bench_check(ok, "reduced header");
+  bench_check(queuebuf_numfree() == QUEUEBUF_NUM, "all freed");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("queuebuf benchmark, %s\n",
+         PACKETBUF_POOL_SIZE ? "packet buffer pool" : "single packetbuf");
+  queuebuf_init();
+  run();
+  check_queued();
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Routing table benchmark: the cost of longest-prefix-match
+ *         lookups as the routing table grows.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "lib/random.h"
+
+#include "bench.h"
+
+#define LOOKUPS 10000
+#define MAX_SIZE 10000
+#define NEXTHOPS 8
+
+PROCESS(bench_process, "route benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+/* Host routes go into fd00::/64, which also gets a route of its own.
+   The other routes are /48 prefixes in fd01::/16, each with a longer
+   /64 prefix inside it. */
+static uip_ds6_route_t *routes[MAX_SIZE];
+static uip_ipaddr_t addrs[MAX_SIZE];
+static uip_ipaddr_t lookups[LOOKUPS];
+static uip_ipaddr_t nexthops[NEXTHOPS];
+static uip_ds6_route_t *subnet;
+static unsigned long num_hosts, num_prefixes;
+static const unsigned long sizes[] = { 100, 1000, MAX_SIZE };
+/*---------------------------------------------------------------------------*/
+static void
+random_bytes(uip_ipaddr_t *addr, int from, int to)
+{
+  int i;
+
+  for(i = from; i < to; i++) {
+    addr->u8[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+add(uip_ipaddr_t *addr, uint8_t length, unsigned long i)
+{
+  return uip_ds6_route_add(addr, length, &nexthops[i % NEXTHOPS]);
+}
+/*---------------------------------------------------------------------------*/
+static void
+clear(void)
+{
+  while(uip_ds6_route_head() != NULL) {
+    uip_ds6_route_rm(uip_ds6_route_head());
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Get an address covered by route i and by no longer route, along
+   with that route */
+static uip_ds6_route_t *
+address_of(unsigned long i, uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r = routes[i];
+
+  uip_ipaddr_copy(addr, &r->ipaddr);
+  if(r->length == 64) {
+    random_bytes(addr, 8, 16);
+  } else if(r->length == 48) {
+    /* Stay clear of the /64 prefix inside this one */
+    random_bytes(addr, 8, 16);
+    addr->u8[6] = ~routes[i + 1]->ipaddr.u8[6];
+  }
+  return r;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(unsigned long n)
+{
+  uip_ipaddr_t addr;
+  unsigned long i, found;
+  uint64_t start;
+  int ok;
+
+  clear();
+
+  /* Add the longer prefixes first, since adding a route replaces any
+     covering route that has another next hop */
+  ok = 1;
+  num_prefixes = n / 10 & ~1UL;
+  num_hosts = n - num_prefixes - 1;
+  start = bench_now();
+  for(i = 0; i < num_hosts; i++) {
+    uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+    random_bytes(&addr, 8, 16);
+    ok &= (routes[i] = add(&addr, 128, i)) != NULL;
+  }
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  ok &= (subnet = add(&addr, 64, i)) != NULL;
+  for(; i < num_hosts + num_prefixes; i += 2) {
+    uip_ip6addr(&addr, 0xfd01, 0, 0, 0, 0, 0, 0, 0);
+    random_bytes(&addr, 2, 8);
+    ok &= (routes[i + 1] = add(&addr, 64, i + 1)) != NULL;
+    memset(&addr.u8[6], 0, 2);
+    ok &= (routes[i] = add(&addr, 48, i)) != NULL;
+  }
+  bench_report("route", n, "add", bench_now() - start, n);
+  bench_check(ok && uip_ds6_route_num_routes() == n, "add");
+
+  for(i = 0; i < LOOKUPS; i++) {
+    uip_ipaddr_copy(&lookups[i], &routes[random_rand() % num_hosts]->ipaddr);
+  }
+  found = 0;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += uip_ds6_route_lookup(&lookups[i]) != NULL;
+  }
+  bench_report("route", n, "hit /128", bench_now() - start, LOOKUPS);
+  bench_check(found == LOOKUPS, "host lookups");
+
+  for(i = 0; i < LOOKUPS; i++) {
+    address_of(num_hosts + random_rand() % num_prefixes, &lookups[i]);
+  }
+  found = 0;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += uip_ds6_route_lookup(&lookups[i]) != NULL;
+  }
+  bench_report("route", n, "hit prefix", bench_now() - start, LOOKUPS);
+  bench_check(found == LOOKUPS, "prefix lookups");
+
+  for(i = 0; i < LOOKUPS; i++) {
+    uip_ip6addr(&lookups[i], 0xfd02, 0, 0, 0, 0, 0, 0, 0);
+    random_bytes(&lookups[i], 2, 16);
+  }
+  found = 0;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += uip_ds6_route_lookup(&lookups[i]) != NULL;
+  }
+  bench_report("route", n, "miss", bench_now() - start, LOOKUPS);
+  bench_check(found == 0, "lookup misses");
+
+  /* Every route must be the longest match for its addresses */
+  ok = 1;
+  for(i = 0; i < num_hosts + num_prefixes; i++) {
+    ok &= address_of(i, &addrs[i]) == uip_ds6_route_lookup(&addrs[i]);
+  }
+  bench_check(ok, "longest match");
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_removal(void)
+{
+  uip_ds6_route_t *expected;
+  uip_ipaddr_t addr;
+  unsigned long i;
+  int ok;
+
+  /* Remove every third route. Hosts then fall back to their subnet,
+     and /64 prefixes to the /48 prefix around them. */
+  for(i = 0; i < num_hosts + num_prefixes; i += 3) {
+    uip_ds6_route_rm(routes[i]);
+  }
+  ok = 1;
+  for(i = 0; i < num_hosts + num_prefixes; i++) {
+    if(i % 3 != 0) {
+      expected = routes[i];
+    } else if(i < num_hosts) {
+      expected = subnet;
+    } else if((i - num_hosts) % 2 == 1) {
+      expected = routes[i - 1];
+    } else {
+      expected = NULL;
+    }
+    ok &= uip_ds6_route_lookup(&addrs[i]) == expected;
+  }
+  bench_check(ok, "lookup after removal");
+
+  uip_ds6_route_rm(subnet);
+  clear();
+  uip_ip6addr(&addr, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  bench_check(uip_ds6_route_num_routes() == 0 &&
+              uip_ds6_route_lookup(&addr) == NULL, "remove all");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  uip_lladdr_t lladdr;
+  int i;
+
+  PROCESS_BEGIN();
+
+  memset(&lladdr, 0, sizeof(lladdr));
+  for(i = 0; i < NEXTHOPS; i++) {
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+    lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+    uip_ds6_nbr_add(&nexthops[i], &lladdr, 0, NBR_REACHABLE,
+                    NBR_TABLE_REASON_UNDEFINED, NULL);
+  }
+
+  printf("route benchmark, %s\n", UIP_DS6_ROUTE_TRIE ? "trie" : "list");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+  check_removal();
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
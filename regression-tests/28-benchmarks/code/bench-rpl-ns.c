@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         RPL non-storing mode benchmark: the cost of finding nodes and
+ *         of inserting source routing headers at the root as the
+ *         network grows, and while a node keeps changing parents.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/rpl/rpl-private.h"
+#include "net/rpl/rpl-ns.h"
+#include "lib/random.h"
+
+#include "bench.h"
+
+#define LOOKUPS 100000
+#define MAX_SIZE 1000
+/* Children per node in the tree of nodes */
+#define FANOUT 4
+/* Packets sent between two moves of a node */
+#define CHURN 10
+
+#define UIP_IP_BUF ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UIP_RH_BUF ((struct uip_routing_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+#define UIP_RPL_SRH_BUF ((struct uip_rpl_srh_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN + RPL_RH_LEN])
+
+PROCESS(bench_process, "rpl-ns benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+static rpl_dag_t *dag;
+static uip_ipaddr_t root;
+static uip_ipaddr_t addrs[MAX_SIZE];
+/* The parent of each node, or -1 for the root */
+static int parents[MAX_SIZE];
+static const unsigned long sizes[] = { 10, 100, MAX_SIZE };
+static unsigned long added;
+/*---------------------------------------------------------------------------*/
+static const uip_ipaddr_t *
+parent_addr(int i)
+{
+  return parents[i] < 0 ? &root : &addrs[parents[i]];
+}
+/*---------------------------------------------------------------------------*/
+/* Put a UDP packet from the root to a node in uip_buf and let RPL
+   insert its headers */
+static int
+send_to(const uip_ipaddr_t *dest)
+{
+  memset(UIP_IP_BUF, 0, UIP_IPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[1] = UIP_UDPH_LEN;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = uip_ds6_if.cur_hop_limit;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &root);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, dest);
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN;
+  uip_ext_len = 0;
+  return rpl_update_header();
+}
+/*---------------------------------------------------------------------------*/
+/* Check that the packet in uip_buf follows the path to node i */
+static int
+check_path(int i)
+{
+  uint8_t cmpr, hops;
+  const uint8_t *hop;
+  int n;
+
+  if(parents[i] < 0) {
+    /* A child of the root is reached directly */
+    return UIP_IP_BUF->proto == UIP_PROTO_UDP &&
+      uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &addrs[i]);
+  }
+  if(UIP_IP_BUF->proto != UIP_PROTO_ROUTING ||
+     UIP_RH_BUF->routing_type != RPL_RH_TYPE_SRH) {
+    return 0;
+  }
+
+  /* The last address is the destination, preceded by its ancestors
+     up to the child of the root, which is the IPv6 destination */
+  cmpr = UIP_RPL_SRH_BUF->cmpr >> 4;
+  hops = UIP_RH_BUF->seg_left;
+  hop = (uint8_t *)UIP_RPL_SRH_BUF + RPL_SRH_LEN + hops * (16 - cmpr);
+  for(n = i; parents[n] >= 0; n = parents[n]) {
+    if(hops-- == 0) {
+      return 0;
+    }
+    hop -= 16 - cmpr;
+    if(memcmp(hop, &addrs[n].u8[cmpr], 16 - cmpr) != 0) {
+      return 0;
+    }
+  }
+  return hops == 0 && uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &addrs[n]);
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_all(void)
+{
+  unsigned long i;
+
+  for(i = 0; i < added; i++) {
+    if(!send_to(&addrs[i]) || !check_path(i)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(unsigned long n)
+{
+  unsigned long i, found;
+  uint64_t start;
+  int ok;
+
+  /* Grow the tree from the size of the previous round */
+  ok = 1;
+  start = bench_now();
+  for(i = added; i < n; i++) {
+    uip_ip6addr(&addrs[i], 0xfd00, 0, 0, 0, 0, 0, 0, i + 2);
+    parents[i] = i < FANOUT ? -1 : i / FANOUT - 1;
+    ok &= rpl_ns_update_node(dag, &addrs[i], parent_addr(i),
+                             RPL_LIFETIME(dag->instance,
+                                          dag->instance->default_lifetime))
+      != NULL;
+  }
+  bench_report("rpl-ns", n, "update", bench_now() - start, n - added);
+  bench_check(ok, "update");
+  added = n;
+
+  found = 0;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    found += rpl_ns_get_node(dag, &addrs[random_rand() % n]) != NULL;
+  }
+  bench_report("rpl-ns", n, "lookup", bench_now() - start, LOOKUPS);
+  bench_check(found == LOOKUPS, "lookups");
+
+  ok = 1;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    ok &= send_to(&addrs[random_rand() % n]);
+  }
+  bench_report("rpl-ns", n, "srh", bench_now() - start, LOOKUPS);
+  bench_check(ok, "srh insertion");
+  bench_check(check_all(), "srh paths");
+
+  /* Keep moving the last node between two parents */
+  ok = 1;
+  start = bench_now();
+  for(i = 0; i < LOOKUPS; i++) {
+    if(i % CHURN == 0) {
+      parents[n - 1] ^= 1;
+      rpl_ns_update_node(dag, &addrs[n - 1], parent_addr(n - 1),
+                         RPL_LIFETIME(dag->instance,
+                                      dag->instance->default_lifetime));
+    }
+    ok &= send_to(&addrs[random_rand() % n]);
+  }
+  bench_report("rpl-ns", n, "srh churn", bench_now() - start, LOOKUPS);
+  bench_check(ok && check_all(), "srh paths with churn");
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_updates(void)
+{
+  unsigned long i;
+  int j, ok;
+
+  /* Move the first grandchild of the root, with its subtree, to the
+     next child of the root */
+  i = FANOUT;
+  parents[i] = parents[i] + 1;
+  rpl_ns_update_node(dag, &addrs[i], parent_addr(i),
+                     RPL_LIFETIME(dag->instance,
+                                  dag->instance->default_lifetime));
+  bench_check(check_all(), "srh paths after move");
+
+  /* Let the last node go away after a No-Path DAO */
+  i = added - 1;
+  rpl_ns_expire_parent(dag, &addrs[i], parent_addr(i));
+  for(j = 0; j <= RPL_NOPATH_REMOVAL_DELAY; j++) {
+    rpl_ns_periodic();
+  }
+  ok = rpl_ns_get_node(dag, &addrs[i]) == NULL &&
+    send_to(&addrs[i]) && UIP_IP_BUF->proto == UIP_PROTO_UDP;
+  added--;
+  bench_check(ok, "removal");
+  bench_check(check_all(), "srh paths after removal");
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  uip_ip6addr(&root, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  uip_ds6_addr_add(&root, 0, ADDR_MANUAL);
+  dag = rpl_set_root(RPL_DEFAULT_INSTANCE, &root);
+  rpl_set_prefix(dag, &root, 64);
+
+  printf("rpl-ns benchmark, %s, %s\n", RPL_NS_HASH ? "hash" : "list",
+         RPL_NS_SRH_CACHE ? "srh cache" : "no srh cache");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    run(sizes[i]);
+  }
+  check_updates();
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
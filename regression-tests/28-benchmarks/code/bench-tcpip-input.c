@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         TCP/IP input benchmark: the cost of handing received UDP
+ *         datagrams to the stack the way the native network driver
+ *         does, one frame each time it is polled, or queued in
+ *         batches when TCPIP_CONF_INPUT_QUEUE is set. Also checks
+ *         that every datagram reaches the application intact.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/ip/tcpip.h"
+#include "net/ip/simple-udp.h"
+#include "net/ipv6/uip-ds6.h"
+
+#include "bench.h"
+
+#define ROUNDS 200000
+#define PAYLOAD_LEN 32
+#define PORT 5683
+#define PACKET_LEN (UIP_LLH_LEN + UIP_IPUDPH_LEN + PAYLOAD_LEN)
+
+#define IP_BUF ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UDP_BUF ((struct uip_udp_hdr *)&uip_buf[UIP_LLIPH_LEN])
+
+PROCESS(bench_process, "TCP/IP input benchmark");
+PROCESS(feed_process, "Packet feeder");
+AUTOSTART_PROCESSES(&bench_process);
+
+static struct simple_udp_connection conn;
+static uint8_t packet[PACKET_LEN];
+static unsigned long fed, received, intact;
+/*---------------------------------------------------------------------------*/
+static void
+receiver(struct simple_udp_connection *c,
+         const uip_ipaddr_t *sender_addr,
+         uint16_t sender_port,
+         const uip_ipaddr_t *receiver_addr,
+         uint16_t receiver_port,
+         const uint8_t *data,
+         uint16_t datalen)
+{
+  if(datalen == PAYLOAD_LEN &&
+     memcmp(data, &packet[PACKET_LEN - PAYLOAD_LEN], PAYLOAD_LEN) == 0) {
+    intact++;
+  }
+  if(++received == ROUNDS) {
+    process_poll(&bench_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A datagram from a link-local neighbor to our link-local address */
+static void
+make_packet(void)
+{
+  int i;
+
+  uip_clear_buf();
+  memset(uip_buf, 0, PACKET_LEN);
+  IP_BUF->vtc = 0x60;
+  IP_BUF->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+  IP_BUF->proto = UIP_PROTO_UDP;
+  IP_BUF->ttl = 64;
+  uip_ip6addr(&IP_BUF->srcipaddr, 0xfe80, 0, 0, 0, 0, 0, 0, 1);
+  uip_ipaddr_copy(&IP_BUF->destipaddr, &uip_ds6_get_link_local(-1)->ipaddr);
+  UDP_BUF->srcport = UIP_HTONS(PORT);
+  UDP_BUF->destport = UIP_HTONS(PORT);
+  UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  for(i = UIP_LLH_LEN + UIP_IPUDPH_LEN; i < PACKET_LEN; i++) {
+    uip_buf[i] = i;
+  }
+  UDP_BUF->udpchksum = ~uip_udpchksum();
+  memcpy(packet, uip_buf, PACKET_LEN);
+  uip_clear_buf();
+}
+/*---------------------------------------------------------------------------*/
+static void
+feed(void)
+{
+#if TCPIP_INPUT_QUEUE
+  uint8_t *buf;
+
+  while(fed < ROUNDS && (buf = tcpip_input_get_buf()) != NULL) {
+    memcpy(buf, packet, PACKET_LEN);
+    tcpip_input_put_buf(PACKET_LEN);
+    fed++;
+  }
+#else /* TCPIP_INPUT_QUEUE */
+  memcpy(uip_buf, packet, PACKET_LEN);
+  uip_len = PACKET_LEN;
+  tcpip_input();
+  fed++;
+#endif /* TCPIP_INPUT_QUEUE */
+
+  if(fed < ROUNDS) {
+    process_poll(&feed_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(feed_process, ev, data)
+{
+  PROCESS_POLLHANDLER(feed());
+
+  PROCESS_BEGIN();
+
+  process_poll(&feed_process);
+  PROCESS_WAIT_UNTIL(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  static uint64_t start;
+
+  PROCESS_BEGIN();
+
+  printf("TCP/IP input benchmark, queue of %d\n", TCPIP_INPUT_QUEUE);
+
+  simple_udp_register(&conn, PORT, NULL, PORT, receiver);
+  make_packet();
+
+  start = bench_now();
+  process_start(&feed_process, NULL);
+  PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  bench_report("tcpip", TCPIP_INPUT_QUEUE, "input", bench_now() - start,
+               ROUNDS);
+
+  bench_check(received == ROUNDS && intact == ROUNDS,
+              "all datagrams received intact");
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
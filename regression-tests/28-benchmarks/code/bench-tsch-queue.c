@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         TSCH queue benchmark: the cost of looking a neighbor up, and
+ *         of a shared slot in which a unicast packet is picked for any
+ *         neighbor and backoff windows are updated, with a growing
+ *         number of neighbors. Also checks that neighbors with a tx
+ *         link or in backoff are not picked, and that those coming out
+ *         of backoff are, that packets of higher traffic classes go
+ *         first, and that 6LoWPAN puts RPL control messages in the
+ *         highest class.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/ip/tcpip.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "net/rime/rime.h"
+#include "net/rpl/rpl-private.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-queue.h"
+#include "net/mac/tsch/tsch-schedule.h"
+#include "net/mac/tsch/tsch-private.h"
+
+#include "bench.h"
+
+#define ROUNDS 100000
+/* Packets queued in each class, leaving a queuebuf for the neighbor
+   that already has a packet */
+#define CLASS_PACKETS ((QUEUEBUF_NUM - 1) / TSCH_QUEUE_CLASSES)
+
+#define IP_BUF ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define ICMP_BUF ((struct uip_icmp_hdr *)&uip_buf[UIP_LLIPH_LEN])
+
+PROCESS(bench_process, "TSCH queue benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+static const unsigned sizes[] = { 8, 32, 128, 512 };
+static struct tsch_slotframe *sf;
+static struct tsch_link *shared_link;
+/*---------------------------------------------------------------------------*/
+/* TSCH does not run on native: stand in for the parts of it that the
+   queues and the schedule use */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0, 0, 0, 0, 0, 0, 0, 0 } };
+struct tsch_link *current_link;
+int tsch_is_coordinator;
+
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+
+void
+tsch_release_lock(void)
+{
+}
+
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+
+void
+tsch_schedule_keepalive(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_addr(linkaddr_t *addr, unsigned i)
+{
+  memset(addr, 0, sizeof(linkaddr_t));
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 2] = i >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = i;
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_neighbor *
+nbr(unsigned i)
+{
+  linkaddr_t addr;
+
+  make_addr(&addr, i);
+  return tsch_queue_get_nbr(&addr);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_packet_of_class(unsigned i, unsigned c)
+{
+  linkaddr_t addr;
+
+  make_addr(&addr, i);
+  packetbuf_clear();
+  packetbuf_set_datalen(20);
+#if TSCH_QUEUE_CLASSES > 1
+  packetbuf_set_attr(PACKETBUF_ATTR_TSCH_CLASS, c);
+#endif /* TSCH_QUEUE_CLASSES > 1 */
+  tsch_queue_add_packet(&addr, NULL, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_packet(unsigned i)
+{
+  add_packet_of_class(i, 0);
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_neighbor *
+shared_slot(void)
+{
+  struct tsch_neighbor *n = NULL;
+
+  if(tsch_queue_get_unicast_packet_for_any(&n, shared_link) == NULL) {
+    n = NULL;
+  }
+  tsch_queue_update_all_backoff_windows(&tsch_broadcast_address);
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+empty_queue(unsigned i)
+{
+  struct tsch_neighbor *n = nbr(i);
+
+  while(!tsch_queue_is_empty(n)) {
+    tsch_queue_free_packet(tsch_queue_remove_packet_from_queue(n));
+  }
+  tsch_queue_backoff_reset(n);
+}
+/*---------------------------------------------------------------------------*/
+static int
+check(unsigned size)
+{
+  struct tsch_link *l;
+  linkaddr_t addr;
+  unsigned i;
+  int ok = 1;
+
+  /* Every neighbor is found, unknown ones are not */
+  for(i = 1; i <= size; i++) {
+    make_addr(&addr, i);
+    ok &= nbr(i) != NULL && linkaddr_cmp(&nbr(i)->addr, &addr);
+  }
+  ok &= nbr(size + 1) == NULL;
+
+  /* The last neighbor has a packet, it is picked */
+  ok &= shared_slot() == nbr(size);
+
+  /* Not while it has a tx link, again once the link is removed */
+  make_addr(&addr, size);
+  l = tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_NORMAL, &addr, 3, 0);
+  ok &= shared_slot() == NULL;
+  tsch_queue_backoff_inc(nbr(size));
+  i = nbr(size)->backoff_window;
+  tsch_queue_update_all_backoff_windows(&addr);
+  ok &= nbr(size)->backoff_window == i - 1;
+  tsch_queue_backoff_reset(nbr(size));
+  tsch_schedule_remove_link(sf, l);
+  ok &= shared_slot() == nbr(size);
+
+  /* Not while in backoff, again once out of it */
+  tsch_queue_backoff_inc(nbr(size));
+  for(i = 0; nbr(size)->backoff_window != 0; i++) {
+    ok &= shared_slot() == NULL;
+  }
+  ok &= shared_slot() == nbr(size);
+
+  /* Not once its queue is empty, and the first neighbor is picked
+     once it has a packet */
+  empty_queue(size);
+  ok &= shared_slot() == NULL;
+  add_packet(1);
+  ok &= shared_slot() == nbr(1);
+  empty_queue(1);
+  add_packet(size);
+
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+#if TSCH_QUEUE_CLASSES > 1
+/* Send the packet picked for a neighbor, return its class */
+static int
+send_next(struct tsch_neighbor *n)
+{
+  struct tsch_packet *p;
+  int c;
+
+  p = tsch_queue_get_packet_for_nbr(n, NULL);
+  if(p == NULL) {
+    return -1;
+  }
+  c = queuebuf_attr(p->qb, PACKETBUF_ATTR_TSCH_CLASS);
+  p->ret = MAC_TX_OK;
+  if(tsch_queue_remove_packet_from_queue(n) != p) {
+    c = -1;
+  }
+  tsch_queue_free_packet(p);
+  return c;
+}
+/*---------------------------------------------------------------------------*/
+/* A neighbor with bulk packets in the lowest class and a few in the
+   others, sent to over a dedicated link */
+static int
+check_classes(void)
+{
+#ifdef TSCH_QUEUE_CLASS_WEIGHTS
+  static const uint8_t weights[] = TSCH_QUEUE_CLASS_WEIGHTS;
+  int sent[TSCH_QUEUE_CLASSES];
+  int round;
+#endif /* TSCH_QUEUE_CLASS_WEIGHTS */
+  struct tsch_neighbor *n;
+#if TSCH_QUEUE_STATS
+  unsigned long sent_before;
+#endif /* TSCH_QUEUE_STATS */
+  int i, c;
+  int ok = 1;
+
+  for(c = 0; c < TSCH_QUEUE_CLASSES; c++) {
+    for(i = 0; i < CLASS_PACKETS; i++) {
+      add_packet_of_class(1, c);
+    }
+  }
+  n = nbr(1);
+  ok &= tsch_queue_packet_count(&n->addr) ==
+    TSCH_QUEUE_CLASSES * CLASS_PACKETS;
+#if TSCH_QUEUE_STATS
+  sent_before = tsch_queue_stats[TSCH_QUEUE_CLASSES - 1].sent;
+#endif /* TSCH_QUEUE_STATS */
+
+#ifdef TSCH_QUEUE_CLASS_WEIGHTS
+  /* Each class gets its share in every round. The earlier checks
+     have sent to this neighbor, so start from a fresh round */
+  memcpy(n->tx_credits, weights, sizeof(n->tx_credits));
+  round = 0;
+  for(c = 0; c < TSCH_QUEUE_CLASSES; c++) {
+    sent[c] = 0;
+    round += weights[c];
+  }
+  for(i = 0; i < round; i++) {
+    c = send_next(n);
+    ok &= c >= 0;
+    if(c >= 0) {
+      sent[c]++;
+    }
+  }
+  for(c = 0; c < TSCH_QUEUE_CLASSES; c++) {
+    ok &= sent[c] == weights[c];
+  }
+#if TSCH_QUEUE_STATS
+  ok &= tsch_queue_stats[TSCH_QUEUE_CLASSES - 1].sent ==
+    sent_before + weights[TSCH_QUEUE_CLASSES - 1];
+#endif /* TSCH_QUEUE_STATS */
+#else /* TSCH_QUEUE_CLASS_WEIGHTS */
+  /* All packets of a class go before those of lower ones */
+  for(c = TSCH_QUEUE_CLASSES - 1; c >= 0; c--) {
+    for(i = 0; i < CLASS_PACKETS; i++) {
+      ok &= send_next(n) == c;
+    }
+  }
+#if TSCH_QUEUE_STATS
+  ok &= tsch_queue_stats[TSCH_QUEUE_CLASSES - 1].sent ==
+    sent_before + CLASS_PACKETS;
+#endif /* TSCH_QUEUE_STATS */
+#endif /* TSCH_QUEUE_CLASS_WEIGHTS */
+
+  /* A packet of the highest class overtakes the others */
+  if(!tsch_queue_is_empty(n)) {
+    tsch_queue_free_packet(tsch_queue_remove_packet_from_queue(n));
+  }
+  add_packet_of_class(1, TSCH_QUEUE_CLASSES - 1);
+  ok &= send_next(n) == TSCH_QUEUE_CLASSES - 1;
+
+  while(!tsch_queue_is_empty(n)) {
+    tsch_queue_free_packet(tsch_queue_remove_packet_from_queue(n));
+  }
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+/* The class of the last packet 6LoWPAN sent */
+static int sent_class;
+
+static void
+sniff_input(void)
+{
+}
+static void
+sniff_output(int mac_status)
+{
+  sent_class = packetbuf_attr(PACKETBUF_ATTR_TSCH_CLASS);
+}
+RIME_SNIFFER(sniffer, sniff_input, sniff_output);
+/*---------------------------------------------------------------------------*/
+/* Send an ICMPv6 message to all RPL nodes through 6LoWPAN, and get the
+   class it was given */
+static int
+icmp6_class(uint8_t type, uint8_t code)
+{
+  int len = UIP_ICMPH_LEN + 4;
+
+  uip_clear_buf();
+  memset(uip_buf, 0, UIP_LLIPH_LEN + len);
+  IP_BUF->vtc = 0x60;
+  IP_BUF->len[1] = len;
+  IP_BUF->proto = UIP_PROTO_ICMP6;
+  IP_BUF->ttl = 64;
+  uip_ip6addr(&IP_BUF->srcipaddr, 0xfe80, 0, 0, 0, 0, 0, 0, 1);
+  uip_ip6addr(&IP_BUF->destipaddr, 0xff02, 0, 0, 0, 0, 0, 0, 0x1a);
+  ICMP_BUF->type = type;
+  ICMP_BUF->icode = code;
+  uip_len = UIP_IPH_LEN + len;
+
+  sent_class = -1;
+  tcpip_output(NULL);
+  return sent_class;
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_control_class(void)
+{
+  int ok;
+
+  rime_sniffer_add(&sniffer);
+  ok = icmp6_class(ICMP6_RPL, RPL_CODE_DIS) == TSCH_QUEUE_CLASSES - 1 &&
+    icmp6_class(ICMP6_RPL, RPL_CODE_DIO) == TSCH_QUEUE_CLASSES - 1 &&
+    icmp6_class(ICMP6_RPL, RPL_CODE_DAO) == TSCH_QUEUE_CLASSES - 1 &&
+    icmp6_class(ICMP6_ECHO_REQUEST, 0) == 0;
+  rime_sniffer_remove(&sniffer);
+  return ok;
+}
+#endif /* TSCH_QUEUE_CLASSES > 1 */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  linkaddr_t addr;
+  unsigned long i;
+  uint64_t start;
+  int s;
+  unsigned n;
+
+  PROCESS_BEGIN();
+
+  printf("TSCH queue benchmark, %s, %s\n",
+         TSCH_QUEUE_HASH ? "hashed" : "list",
+         TSCH_QUEUE_READY_LIST ? "ready list" : "no ready list");
+
+  tsch_queue_init();
+  tsch_schedule_init();
+  sf = tsch_schedule_add_slotframe(0, 7);
+  shared_link = tsch_schedule_add_link(sf,
+                                       LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED,
+                                       LINK_TYPE_NORMAL, &tsch_broadcast_address, 0, 0);
+
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    /* Neighbors we have no tx link to, the last one with a packet */
+    for(n = 1; n <= sizes[s]; n++) {
+      make_addr(&addr, n);
+      tsch_queue_add_nbr(&addr);
+    }
+    add_packet(sizes[s]);
+
+    start = bench_now();
+    for(i = 0; i < ROUNDS; i++) {
+      make_addr(&addr, 1 + i % sizes[s]);
+      tsch_queue_get_nbr(&addr);
+    }
+    bench_report("tsch-queue", sizes[s], "get nbr", bench_now() - start,
+                 ROUNDS);
+
+    start = bench_now();
+    for(i = 0; i < ROUNDS; i++) {
+      shared_slot();
+    }
+    bench_report("tsch-queue", sizes[s], "shared slot", bench_now() - start,
+                 ROUNDS);
+
+    bench_check(check(sizes[s]), "packets picked from eligible neighbors");
+#if TSCH_QUEUE_CLASSES > 1
+    bench_check(check_classes(), "packets picked by class");
+#endif /* TSCH_QUEUE_CLASSES > 1 */
+
+    empty_queue(sizes[s]);
+    tsch_queue_free_unused_neighbors();
+    bench_check(nbr(1) == NULL && nbr(sizes[s]) == NULL &&
+                tsch_queue_get_nbr(&tsch_broadcast_address) == n_broadcast,
+                "unused neighbors freed");
+  }
+
+#if TSCH_QUEUE_CLASSES > 1
+  bench_check(check_control_class(), "RPL control messages in the highest class");
+#endif /* TSCH_QUEUE_CLASSES > 1 */
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
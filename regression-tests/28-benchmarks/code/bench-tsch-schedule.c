@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         TSCH schedule benchmark: the cost of finding the next active
+ *         link, as the slot operation does every slot, for schedules
+ *         with a growing number of links. Also checks that the link,
+ *         its backup and the time to it are the ones a walk through
+ *         all links of all slotframes finds.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "net/mac/tsch/tsch-schedule.h"
+#include "net/mac/tsch/tsch-private.h"
+
+#include "bench.h"
+
+#define ROUNDS 100000
+#define CHECKS 20000
+/* A unicast slotframe holding most of the links, as Orchestra's */
+#define UNICAST_SIZE 1021
+#define UNICAST_HANDLE 2
+
+PROCESS(bench_process, "TSCH schedule benchmark");
+AUTOSTART_PROCESSES(&bench_process);
+
+static const unsigned sizes[] = { 8, 32, 128, 512 };
+/*---------------------------------------------------------------------------*/
+/* TSCH does not run on native: stand in for the parts of it that the
+   schedule uses */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+struct tsch_link *current_link;
+
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+
+void
+tsch_release_lock(void)
+{
+}
+
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+
+void
+tsch_queue_update_nbr(struct tsch_neighbor *n)
+{
+}
+/*---------------------------------------------------------------------------*/
+/* The next active link found by going through all links */
+static struct tsch_link *
+next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset,
+                 struct tsch_link **backup_link)
+{
+  uint16_t time_to_curr_best = 0;
+  struct tsch_link *curr_best = NULL;
+  struct tsch_link *curr_backup = NULL;
+  struct tsch_slotframe *sf;
+  uint16_t handle;
+
+  for(handle = 0; handle <= UNICAST_HANDLE; handle++) {
+    uint16_t timeslot;
+    struct tsch_link *l;
+
+    sf = tsch_schedule_get_slotframe_by_handle(handle);
+    timeslot = TSCH_ASN_MOD(*asn, sf->size);
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      uint16_t time_to_timeslot =
+        l->timeslot > timeslot ?
+        l->timeslot - timeslot :
+        sf->size.val + l->timeslot - timeslot;
+      if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
+        time_to_curr_best = time_to_timeslot;
+        curr_best = l;
+        curr_backup = NULL;
+      } else if(time_to_timeslot == time_to_curr_best) {
+        struct tsch_link *new_best = NULL;
+        if((curr_best->link_options & LINK_OPTION_TX) ==
+           (l->link_options & LINK_OPTION_TX)) {
+          if(l->slotframe_handle < curr_best->slotframe_handle) {
+            new_best = l;
+          }
+        } else if(l->link_options & LINK_OPTION_TX) {
+          new_best = l;
+        }
+        if(curr_backup == NULL) {
+          if(new_best != l && (l->link_options & LINK_OPTION_RX)) {
+            curr_backup = l;
+          }
+          if(new_best != curr_best &&
+             (curr_best->link_options & LINK_OPTION_RX)) {
+            curr_backup = curr_best;
+          }
+        }
+        if(new_best != NULL) {
+          curr_best = new_best;
+        }
+      }
+    }
+  }
+  *time_offset = time_to_curr_best;
+  *backup_link = curr_backup;
+  return curr_best;
+}
+/*---------------------------------------------------------------------------*/
+/* An Orchestra-like schedule: an EB slotframe, a shared slotframe and
+   a unicast slotframe with one Rx link and n - 3 Tx links, at random
+   timeslots that often overlap with the other slotframes */
+static void
+make_schedule(unsigned n)
+{
+  struct tsch_slotframe *sf;
+  linkaddr_t addr;
+  unsigned i;
+
+  tsch_schedule_remove_all_slotframes();
+
+  sf = tsch_schedule_add_slotframe(0, 397);
+  tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_ADVERTISING_ONLY,
+                         &tsch_broadcast_address, 0, 0);
+  sf = tsch_schedule_add_slotframe(1, 31);
+  tsch_schedule_add_link(sf,
+                         LINK_OPTION_RX | LINK_OPTION_TX | LINK_OPTION_SHARED,
+                         LINK_TYPE_ADVERTISING, &tsch_broadcast_address, 0, 1);
+  sf = tsch_schedule_add_slotframe(UNICAST_HANDLE, UNICAST_SIZE);
+  tsch_schedule_add_link(sf, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                         &linkaddr_null, 1, 2);
+  memset(&addr, 0, sizeof(addr));
+  for(i = 3; i < n; i++) {
+    uint16_t timeslot;
+    do {
+      timeslot = random_rand() % UNICAST_SIZE;
+    } while(tsch_schedule_get_link_by_timeslot(sf, timeslot) != NULL);
+    addr.u8[LINKADDR_SIZE - 1] = i;
+    addr.u8[LINKADDR_SIZE - 2] = i >> 8;
+    tsch_schedule_add_link(sf, LINK_OPTION_TX | LINK_OPTION_SHARED,
+                           LINK_TYPE_NORMAL, &addr, timeslot, 2);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+check(void)
+{
+  struct tsch_asn_t asn;
+  struct tsch_slotframe *sf;
+  struct tsch_link *l, *backup, *expected, *expected_backup;
+  uint16_t offset, expected_offset;
+  unsigned i;
+
+  TSCH_ASN_INIT(asn, 0, 0);
+  for(i = 0; i < CHECKS; i++) {
+    l = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+    expected = next_active_link(&asn, &expected_offset, &expected_backup);
+    if(l != expected || backup != expected_backup ||
+       offset != expected_offset) {
+      return 0;
+    }
+    TSCH_ASN_INC(asn, 1);
+  }
+
+  /* Links are found by timeslot, and no longer once removed */
+  sf = tsch_schedule_get_slotframe_by_handle(UNICAST_HANDLE);
+  for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+    if(tsch_schedule_get_link_by_timeslot(sf, l->timeslot) != l) {
+      return 0;
+    }
+  }
+  l = list_head(sf->links_list);
+  i = l->timeslot;
+  tsch_schedule_remove_link(sf, l);
+  return tsch_schedule_get_link_by_timeslot(sf, i) == NULL;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(bench_process, ev, data)
+{
+  struct tsch_asn_t asn;
+  struct tsch_link *backup;
+  uint16_t offset;
+  unsigned long i;
+  uint64_t start;
+  int s;
+
+  PROCESS_BEGIN();
+
+  printf("TSCH schedule benchmark, %s\n",
+         TSCH_SCHEDULE_INDEX ? "indexed" : "list");
+
+  tsch_schedule_init();
+
+  for(s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    make_schedule(sizes[s]);
+
+    TSCH_ASN_INIT(asn, 0, 0);
+    start = bench_now();
+    for(i = 0; i < ROUNDS; i++) {
+      tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+      /* Go to the next active slot, as the slot operation does */
+      TSCH_ASN_INC(asn, offset);
+    }
+    bench_report("tsch-schedule", sizes[s], "next link",
+                 bench_now() - start, ROUNDS);
+
+    bench_check(check(), "same next link as through all links");
+  }
+
+  bench_exit();
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
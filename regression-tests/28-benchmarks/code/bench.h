@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Helpers shared by the native benchmarks.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+/**
+ * \brief      Get a monotonic timestamp.
+ * \return     The current time in nanoseconds
+ */
+uint64_t bench_now(void);
+
+/**
+ * \brief      Print the cost of an operation.
+ * \param name The name of the benchmark
+ * \param size The size of the data structure being measured
+ * \param op   The name of the operation
+ * \param ns   The time spent on all operations, in nanoseconds
+ * \param ops  The number of operations performed
+ */
+void bench_report(const char *name, unsigned long size, const char *op,
+                  uint64_t ns, unsigned long ops);
+
+/**
+ * \brief      Record the result of a consistency check.
+ * \param ok   Non-zero if the check passed
+ * \param what A description of the check
+ */
+void bench_check(int ok, const char *what);
+
+/**
+ * \brief      End the benchmark and exit the native process.
+ *
+ *             The exit status is non-zero if any check recorded
+ *             with bench_check() failed.
+ */
+void bench_exit(void);
+
+#endif /* BENCH_H_ */
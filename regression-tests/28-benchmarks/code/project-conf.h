@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+/*
+ * Build the benchmarked modules with their scalable configurations.
+ * Each of these can be overridden from the command line to compare
+ * against the default implementation, e.g.
+ * make DEFINES=ETIMER_CONF_HEAP_SIZE=0
+ */
+#ifndef ETIMER_CONF_HEAP_SIZE
+#define ETIMER_CONF_HEAP_SIZE 10240
+#endif
+#ifndef MMEM_CONF_SIZE_CLASSES
+#define MMEM_CONF_SIZE_CLASSES 1
+#endif
+#ifndef NBR_TABLE_CONF_HASH
+#define NBR_TABLE_CONF_HASH 1
+#endif
+#ifndef UIP_DS6_NBR_CONF_HASH
+#define UIP_DS6_NBR_CONF_HASH 1
+#endif
+#ifndef UIP_DS6_ROUTE_CONF_TRIE
+#define UIP_DS6_ROUTE_CONF_TRIE 1
+#endif
+#ifndef RPL_NS_CONF_HASH
+#define RPL_NS_CONF_HASH 1
+#endif
+#ifndef RPL_NS_CONF_SRH_CACHE
+#define RPL_NS_CONF_SRH_CACHE 1024
+#endif
+#ifndef PACKETBUF_CONF_POOL_SIZE
+#define PACKETBUF_CONF_POOL_SIZE 10
+#endif
+#ifndef SICSLOWPAN_CONF_ADDR_CONTEXT_HASH
+#define SICSLOWPAN_CONF_ADDR_CONTEXT_HASH 1
+#endif
+#ifndef SICSLOWPAN_CONF_IPHC_CACHE
+#define SICSLOWPAN_CONF_IPHC_CACHE 4
+#endif
+#ifndef TSCH_SCHEDULE_CONF_INDEX
+#define TSCH_SCHEDULE_CONF_INDEX 1
+#endif
+#ifndef TSCH_QUEUE_CONF_HASH
+#define TSCH_QUEUE_CONF_HASH 1
+#endif
+#ifndef TSCH_QUEUE_CONF_READY_LIST
+#define TSCH_QUEUE_CONF_READY_LIST 1
+#endif
+#ifndef TSCH_QUEUE_CONF_CLASSES
+#define TSCH_QUEUE_CONF_CLASSES 3
+#endif
+#ifndef TCPIP_CONF_INPUT_QUEUE
+#define TCPIP_CONF_INPUT_QUEUE 8
+#endif
+#ifndef MEMB_CONF_FREE_LIST
+#define MEMB_CONF_FREE_LIST 1
+#endif
+#ifndef CSMA_CONF_HASH
+#define CSMA_CONF_HASH 1
+#endif
+#ifndef CSMA_CONF_BURST
+#define CSMA_CONF_BURST 1
+#endif
+#ifndef FRAMER_802154_CONF_HDR_CACHE
+#define FRAMER_802154_CONF_HDR_CACHE 4
+#endif
+#ifndef FRAME802154_CONF_PARSE_FAST
+#define FRAME802154_CONF_PARSE_FAST 1
+#endif
+#ifndef SICSLOWPAN_CONF_FRAG_FORWARD
+#define SICSLOWPAN_CONF_FRAG_FORWARD 2
+#endif
+
+/* Count the packets of each TSCH traffic class */
+#ifndef TSCH_QUEUE_CONF_STATS
+#define TSCH_QUEUE_CONF_STATS 1
+#endif
+
+/* Large enough for the managed memory benchmark */
+#define MMEM_CONF_SIZE 65536
+
+/* Large enough for the neighbor table benchmarks */
+#undef NBR_TABLE_CONF_MAX_NEIGHBORS
+#define NBR_TABLE_CONF_MAX_NEIGHBORS 1024
+
+/* Large enough for the routing table benchmark */
+#undef UIP_CONF_MAX_ROUTES
+#define UIP_CONF_MAX_ROUTES 10000
+
+/* Do not sleep in the main loop while processes have events pending,
+   for the benchmarks that go through the event loop */
+#define SELECT_CONF_TICKLESS 1
+
+/* As many neighbor queues as queuebufs */
+#ifndef CSMA_CONF_MAX_NEIGHBOR_QUEUES
+#define CSMA_CONF_MAX_NEIGHBOR_QUEUES 8
+#endif
+
+/* Large enough for the TSCH schedule benchmark */
+#define TSCH_SCHEDULE_CONF_MAX_LINKS 512
+#define TSCH_LOG_CONF_LEVEL 0
+
+/* Enough contexts for the IPHC benchmark to use a context index */
+#undef SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS
+#define SICSLOWPAN_CONF_MAX_ADDR_CONTEXTS 16
+
+/* Large enough for the non-storing mode benchmark */
+#undef RPL_CONF_MOP
+#define RPL_CONF_MOP RPL_MOP_NON_STORING
+#undef RPL_NS_CONF_LINK_NUM
+#define RPL_NS_CONF_LINK_NUM 1024
+
+#endif /* PROJECT_CONF_H_ */